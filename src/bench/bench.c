@@ -0,0 +1,359 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ncurses.h>
+#include "../game/game.h"
+#include "../game/simulacao.h"
+#include "../game/retrato.h"
+#include "../game/pool.h"
+#include "../modulos/modulos.h"
+#include "../ui/ui.h"
+#include "../estatisticas/estatisticas.h"
+
+// Microbenchmarks das funções quentes (make bench)
+// Cada medição calibra o número de iterações até um lote levar LOTE_MINIMO_NS
+// (o que também serve de aquecimento) e depois mede REPETICOES lotes; imprime
+// a mediana e o mínimo em ns por operação.
+
+// Globais que main.c define para o jogo (usadas por threads.c, reator.c e ui.c)
+char buffer_instrucao_global[64] = "";
+int audio_disponivel_global = 0;
+
+#define LOTE_MINIMO_NS 20000000LL   // 20 ms por lote
+#define REPETICOES 7
+#define MODULOS_AMOSTRA 256         // módulos pré-gerados para validar e exibir
+
+typedef struct {
+    const char *nome;
+    void (*preparar)(void);     // antes de cada lote, fora da medição (ou NULL)
+    void (*executar)(long n);   // n operações
+    long max_iteracoes;         // limite do lote (0 = sem limite)
+    int por_segundo;            // também imprimir operações por segundo (geração)
+} Benchmark;
+
+// Evita que o compilador descarte o resultado das operações medidas
+static volatile long sumidouro;
+
+static Aleatorio aleatorio;
+static Modulo amostra[MODULOS_AMOSTRA];
+static GameState jogo;
+static RetratoTela retrato;
+
+static int comparar_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static long long medir_lote(const Benchmark *b, long n) {
+    if (b->preparar) {
+        b->preparar();
+    }
+    long long inicio = agora_ns();
+    b->executar(n);
+    return agora_ns() - inicio;
+}
+
+static void rodar(const Benchmark *b) {
+    // Calibrar: dobrar o lote até ele durar LOTE_MINIMO_NS (ou bater o limite)
+    long n = 1;
+    for (;;) {
+        long long duracao = medir_lote(b, n);
+        if (duracao >= LOTE_MINIMO_NS || (b->max_iteracoes > 0 && n >= b->max_iteracoes)) {
+            break;
+        }
+        n *= 2;
+        if (b->max_iteracoes > 0 && n > b->max_iteracoes) {
+            n = b->max_iteracoes;
+        }
+    }
+
+    double ns_por_op[REPETICOES];
+    for (int i = 0; i < REPETICOES; i++) {
+        ns_por_op[i] = (double)medir_lote(b, n) / n;
+    }
+    qsort(ns_por_op, REPETICOES, sizeof(double), comparar_double);
+    printf("%-44s %10.1f ns/op  (min %.1f, %ld iteracoes x %d)",
+           b->nome, ns_por_op[REPETICOES / 2], ns_por_op[0], n, REPETICOES);
+    if (b->por_segundo) {
+        printf("  %.2f M/s", 1e3 / ns_por_op[REPETICOES / 2]);
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// GERAÇÃO DE MÓDULOS
+// ============================================================================
+
+static void bench_gerar_botao(long n) {
+    Modulo m;
+    for (long i = 0; i < n; i++) {
+        gerar_modulo_botao(&m, DIFICULDADE_DIFICIL, &aleatorio);
+        sumidouro += m.instrucao_correta[0];
+    }
+}
+
+static void bench_gerar_senha(long n) {
+    Modulo m;
+    for (long i = 0; i < n; i++) {
+        gerar_modulo_senha(&m, DIFICULDADE_DIFICIL, &aleatorio);
+        sumidouro += m.instrucao_correta[0];
+    }
+}
+
+static void bench_gerar_fios(long n) {
+    Modulo m;
+    for (long i = 0; i < n; i++) {
+        gerar_modulo_fios(&m, DIFICULDADE_DIFICIL, &aleatorio);
+        sumidouro += m.instrucao_correta[0];
+    }
+}
+
+// Lote do tamanho da reserva do mural (repor_reserva_modulos); uma operação
+// é um módulo
+static void bench_gerar_lote(long n) {
+    Modulo lote[RESERVA_MODULOS];
+    for (long i = 0; i < n; i += RESERVA_MODULOS) {
+        int qtd = n - i < RESERVA_MODULOS ? (int)(n - i) : RESERVA_MODULOS;
+        gerar_lote_modulos(lote, qtd, DIFICULDADE_DIFICIL, &aleatorio);
+        sumidouro += lote[0].instrucao_correta[0];
+    }
+}
+
+// ============================================================================
+// VALIDAÇÃO E EXIBIÇÃO
+// ============================================================================
+
+static void bench_validar_correta(long n) {
+    for (long i = 0; i < n; i++) {
+        const Modulo *m = &amostra[i % MODULOS_AMOSTRA];
+        sumidouro += validar_instrucao_modulo(m, m->instrucao_correta);
+    }
+}
+
+static void bench_validar_errada(long n) {
+    for (long i = 0; i < n; i++) {
+        sumidouro += validar_instrucao_modulo(&amostra[i % MODULOS_AMOSTRA], "ppcp");
+    }
+}
+
+static void bench_info_exibicao(long n) {
+    char info[64];
+    for (long i = 0; i < n; i++) {
+        obter_info_exibicao_modulo(&amostra[i % MODULOS_AMOSTRA], info, sizeof(info));
+        sumidouro += info[0];
+    }
+}
+
+// ============================================================================
+// POOL DE MÓDULOS
+// ============================================================================
+// Um passo sobre 10 mil módulos vivos, na ordem de criação: conta os módulos
+// por estado e tipo e avança o cronômetro dos em execução, como os passos e as
+// contagens do jogo. Com o tipo lido do vetor quente e com o tipo lido do
+// Modulo (frio), para ver o custo de trazer o registro inteiro para o cache.
+
+#define MODULOS_POOL_GRANDE 10000
+static PoolModulos pool_grande;
+
+// Pool com MODULOS_POOL_GRANDE módulos em estados sorteados (preparado uma vez)
+static void preparar_pool_grande(void) {
+    if (pool_grande.qtd_vivos > 0) {
+        return;
+    }
+    pool_modulos_inicializar(&pool_grande);
+    for (int i = 0; i < MODULOS_POOL_GRANDE; i++) {
+        HandleModulo h = pool_modulos_alocar(&pool_grande);
+        Modulo *m = pool_modulos_obter(&pool_grande, h);
+        int slot = pool_modulos_slot(&pool_grande, h);
+        *m = amostra[i % MODULOS_AMOSTRA];
+        m->id = i + 1;
+        pool_grande.tipo[slot] = (unsigned char)m->tipo;
+        pool_grande.estado[slot] = (unsigned char)aleatorio_abaixo(&aleatorio, 3);
+        pool_grande.tempo_total[slot] = 5 + aleatorio_abaixo(&aleatorio, 20);
+        pool_grande.tempo_restante[slot] = pool_grande.tempo_total[slot];
+        pool_grande.instante_resolvido[slot] = -1;
+    }
+}
+
+static void bench_percorrer_pool(long n) {
+    for (long i = 0; i < n; i++) {
+        int contagem[9] = {0};
+        for (HandleModulo h = pool_modulos_primeiro(&pool_grande); h != MODULO_NENHUM;
+             h = pool_modulos_proximo(&pool_grande, h)) {
+            int slot = pool_modulos_slot(&pool_grande, h);
+            contagem[pool_grande.tipo[slot] * 3 + pool_grande.estado[slot]]++;
+            if (pool_grande.estado[slot] == MOD_EM_EXECUCAO &&
+                --pool_grande.tempo_restante[slot] <= 0) {
+                pool_grande.tempo_restante[slot] = pool_grande.tempo_total[slot];
+            }
+        }
+        sumidouro += contagem[i % 9];
+    }
+}
+
+static void bench_percorrer_pool_tipo_frio(long n) {
+    for (long i = 0; i < n; i++) {
+        int contagem[9] = {0};
+        for (HandleModulo h = pool_modulos_primeiro(&pool_grande); h != MODULO_NENHUM;
+             h = pool_modulos_proximo(&pool_grande, h)) {
+            int slot = pool_modulos_slot(&pool_grande, h);
+            const Modulo *m = pool_modulos_obter(&pool_grande, h);
+            contagem[m->tipo * 3 + pool_grande.estado[slot]]++;
+            if (pool_grande.estado[slot] == MOD_EM_EXECUCAO &&
+                --pool_grande.tempo_restante[slot] <= 0) {
+                pool_grande.tempo_restante[slot] = pool_grande.tempo_total[slot];
+            }
+        }
+        sumidouro += contagem[i % 9];
+    }
+}
+
+// ============================================================================
+// COMANDOS DO COORDENADOR
+// ============================================================================
+// O antigo processar_comando virou interpretar_comando (texto -> Comando) e
+// simular_aplicar_comando (Comando -> estado); simular_comando faz os dois.
+
+#define COMANDOS_LOTE 1000          // tedax, bancadas e módulos da partida de teste
+static char textos_comando[COMANDOS_LOTE][32];
+
+static void bench_interpretar(long n) {
+    Comando cmd;
+    for (long i = 0; i < n; i++) {
+        sumidouro += interpretar_comando(textos_comando[i % COMANDOS_LOTE], COMANDOS_LOTE,
+                                         COMANDOS_LOTE, &cmd);
+    }
+}
+
+// Partida nova com COMANDOS_LOTE tedax e bancadas livres e módulos pendentes:
+// o comando i designa o módulo i para o tedax i, na bancada i
+static void preparar_partida_comandos(void) {
+    if (jogo.tedax) {
+        finalizar_jogo(&jogo);
+    }
+    inicializar_jogo(&jogo, DIFICULDADE_FACIL, COMANDOS_LOTE, COMANDOS_LOTE, 1);
+    trava_travar(&jogo.trava_modulos);
+    while (jogo.qtd_modulos < COMANDOS_LOTE) {
+        gerar_novo_modulo(&jogo);
+    }
+    trava_destravar(&jogo.trava_modulos);
+}
+
+static void bench_comando_aceito(long n) {
+    for (long i = 0; i < n; i++) {
+        sumidouro += simular_comando(&jogo, textos_comando[i]);
+    }
+}
+
+static void bench_comando_rejeitado(long n) {
+    for (long i = 0; i < n; i++) {
+        sumidouro += simular_comando(&jogo, "T1B1M99999:ppp");
+    }
+}
+
+// ============================================================================
+// TELA
+// ============================================================================
+
+// Publicar com a partida de COMANDOS_LOTE módulos: a montagem do retrato
+// depende das linhas que cabem na tela, não de quantos módulos existem
+static void bench_publicar_retrato(long n) {
+    for (long i = 0; i < n; i++) {
+        publicar_retrato_tela(&jogo, "T1B1M9:ppp");
+        sumidouro += obter_retrato_tela(&jogo)->qtd_linhas;
+    }
+}
+
+static void bench_desenhar_tela(long n) {
+    for (long i = 0; i < n; i++) {
+        retrato.tempo_restante = (int)(i % 300); // uma linha muda a cada quadro
+        desenhar_tela(&retrato);
+    }
+}
+
+// Terminal ncurses fora da tela: saída em /dev/null, 50x160
+// Sempre xterm (não o $TERM de quem roda), para a medição não variar de uma
+// máquina para outra; o $TERM só é usado se não houver terminfo do xterm
+static int abrir_terminal_fora_da_tela(void) {
+    FILE *saida = fopen("/dev/null", "w");
+    FILE *entrada = fopen("/dev/null", "r");
+    if (!saida || !entrada) {
+        return 0;
+    }
+    SCREEN *tela = newterm("xterm", saida, entrada);
+    if (!tela && getenv("TERM")) {
+        tela = newterm(getenv("TERM"), saida, entrada);
+    }
+    if (!tela) {
+        return 0;
+    }
+    set_term(tela);
+    resizeterm(50, 160);
+    if (has_colors()) {
+        start_color();
+        init_pair(1, COLOR_CYAN, COLOR_BLACK);
+        init_pair(2, COLOR_GREEN, COLOR_BLACK);
+        init_pair(3, COLOR_YELLOW, COLOR_BLACK);
+    }
+    return 1;
+}
+
+// Retrato de uma partida em andamento: tedax ocupados e a lista de módulos cheia
+static void montar_retrato(void) {
+    preparar_partida_comandos();
+    for (int i = 0; i < 8; i++) {
+        simular_comando(&jogo, textos_comando[i]);
+    }
+    publicar_retrato_tela(&jogo, "T1B1M9:ppp");
+    retrato = *obter_retrato_tela(&jogo);
+}
+
+int main(void) {
+    aleatorio_semear(&aleatorio, 42, 0);
+    gerar_lote_modulos(amostra, MODULOS_AMOSTRA, DIFICULDADE_DIFICIL, &aleatorio);
+    for (int i = 0; i < COMANDOS_LOTE; i++) {
+        snprintf(textos_comando[i], sizeof(textos_comando[i]), "T%dB%dM%d:ppp", i + 1, i + 1, i + 1);
+    }
+
+    const Benchmark benchmarks[] = {
+        {"gerar_modulo_botao", NULL, bench_gerar_botao, 0, 1},
+        {"gerar_modulo_senha", NULL, bench_gerar_senha, 0, 1},
+        {"gerar_modulo_fios", NULL, bench_gerar_fios, 0, 1},
+        {"gerar_lote_modulos (por modulo, DIFICIL)", NULL, bench_gerar_lote, 0, 1},
+        {"validar_instrucao_modulo (correta)", NULL, bench_validar_correta, 0, 0},
+        {"validar_instrucao_modulo (errada)", NULL, bench_validar_errada, 0, 0},
+        {"obter_info_exibicao_modulo", NULL, bench_info_exibicao, 0, 0},
+        {"percorrer pool (10000 modulos)", preparar_pool_grande, bench_percorrer_pool, 0, 0},
+        {"percorrer pool (10000, tipo no Modulo)", preparar_pool_grande,
+         bench_percorrer_pool_tipo_frio, 0, 0},
+        {"interpretar_comando", NULL, bench_interpretar, 0, 0},
+        {"simular_comando (designa modulo)", preparar_partida_comandos, bench_comando_aceito,
+         COMANDOS_LOTE, 0},
+        {"simular_comando (modulo inexistente)", preparar_partida_comandos,
+         bench_comando_rejeitado, 0, 0},
+        {"publicar_retrato_tela (1000 modulos)", preparar_partida_comandos,
+         bench_publicar_retrato, 0, 0},
+    };
+
+    printf("%-44s %10s\n", "benchmark", "mediana");
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        rodar(&benchmarks[i]);
+    }
+
+    if (abrir_terminal_fora_da_tela()) {
+        montar_retrato();
+        const Benchmark tela = {"desenhar_tela (terminal fora da tela)", NULL,
+                                bench_desenhar_tela, 0, 0};
+        rodar(&tela);
+        endwin();
+    } else {
+        printf("%-44s (sem terminal ncurses)\n", "desenhar_tela");
+    }
+
+    if (jogo.tedax) {
+        finalizar_jogo(&jogo);
+    }
+    pool_modulos_finalizar(&pool_grande);
+    return 0;
+}
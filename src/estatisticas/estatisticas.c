@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200809L
+#include "estatisticas.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Retorna o tempo monotônico atual em nanossegundos
+long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Abre o destino dos relatórios de partida
+FILE* abrir_saida_estatisticas(void) {
+    const char *caminho = getenv("TEDAX_STATS");
+    if (caminho && caminho[0] != '\0') {
+        FILE *arquivo = fopen(caminho, "a");
+        if (arquivo) {
+            return arquivo;
+        }
+        fprintf(stderr, "Aviso: nao foi possivel abrir %s, usando stderr\n", caminho);
+    }
+    return stderr;
+}
+
+// Fecha o destino aberto por abrir_saida_estatisticas
+void fechar_saida_estatisticas(FILE *saida) {
+    if (saida && saida != stderr) {
+        fclose(saida);
+    } else if (saida) {
+        fflush(saida);
+    }
+}
+
+// Calcula a faixa de um valor: potência de 2 mais alta e os próximos bits
+static int faixa_histograma(long long valor) {
+    if (valor < HIST_SUBFAIXAS) {
+        return (int)valor;
+    }
+    int bit_alto = 63 - __builtin_clzll((unsigned long long)valor);
+    int sub = (int)((valor >> (bit_alto - 2)) & (HIST_SUBFAIXAS - 1));
+    return (bit_alto - 1) * HIST_SUBFAIXAS + sub;
+}
+
+// Retorna o maior valor que cai na faixa indicada
+static long long limite_faixa(int faixa) {
+    if (faixa < HIST_SUBFAIXAS) {
+        return faixa;
+    }
+    int bit_alto = faixa / HIST_SUBFAIXAS + 1;
+    long long sub = faixa % HIST_SUBFAIXAS;
+    long long base = 1LL << bit_alto;
+    long long largura = base / HIST_SUBFAIXAS;
+    return base + (sub + 1) * largura - 1;
+}
+
+// Zera o histograma
+void histograma_zerar(Histograma *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+// Registra uma amostra
+void histograma_registrar(Histograma *h, long long valor_ns) {
+    if (valor_ns < 0) valor_ns = 0;
+    h->contagem[faixa_histograma(valor_ns)]++;
+    h->total++;
+    h->soma_ns += valor_ns;
+    if (valor_ns > h->max_ns) h->max_ns = valor_ns;
+}
+
+// Soma as amostras de origem em destino
+void histograma_somar(Histograma *destino, const Histograma *origem) {
+    for (int i = 0; i < HIST_FAIXAS; i++) {
+        destino->contagem[i] += origem->contagem[i];
+    }
+    destino->total += origem->total;
+    destino->soma_ns += origem->soma_ns;
+    if (origem->max_ns > destino->max_ns) destino->max_ns = origem->max_ns;
+}
+
+// Retorna o percentil p (0-100)
+long long histograma_percentil(const Histograma *h, double p) {
+    if (h->total == 0) {
+        return 0;
+    }
+    long long alvo = (long long)(h->total * p / 100.0 + 0.5);
+    if (alvo < 1) alvo = 1;
+    long long acumulado = 0;
+    for (int i = 0; i < HIST_FAIXAS; i++) {
+        acumulado += h->contagem[i];
+        if (acumulado >= alvo) {
+            long long limite = limite_faixa(i);
+            return limite < h->max_ns ? limite : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+// Imprime o resumo do histograma em microssegundos
+void histograma_imprimir(FILE *saida, const char *nome, const Histograma *h) {
+    if (h->total == 0) {
+        fprintf(saida, "%s: sem amostras\n", nome);
+        return;
+    }
+    fprintf(saida, "%s: n=%lld media=%.1fus p50=%.1fus p95=%.1fus p99=%.1fus max=%.1fus\n",
+            nome, h->total, h->soma_ns / (double)h->total / 1000.0,
+            histograma_percentil(h, 50) / 1000.0,
+            histograma_percentil(h, 95) / 1000.0,
+            histograma_percentil(h, 99) / 1000.0,
+            h->max_ns / 1000.0);
+}
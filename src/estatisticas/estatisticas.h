@@ -0,0 +1,44 @@
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+#include <stdio.h>
+
+// Histograma de latências em nanossegundos
+// Faixas log-lineares: cada potência de 2 é dividida em HIST_SUBFAIXAS faixas,
+// o que dá erro relativo de no máximo 25% nos percentis com custo O(1) por amostra
+#define HIST_SUBFAIXAS 4
+#define HIST_FAIXAS (64 * HIST_SUBFAIXAS)
+
+typedef struct {
+    long long contagem[HIST_FAIXAS];
+    long long total;            // número de amostras
+    long long soma_ns;          // soma das amostras (para a média)
+    long long max_ns;           // maior amostra
+} Histograma;
+
+// Zera o histograma
+void histograma_zerar(Histograma *h);
+
+// Registra uma amostra (valores negativos contam como 0)
+void histograma_registrar(Histograma *h, long long valor_ns);
+
+// Soma as amostras de origem em destino (histogramas de várias threads)
+void histograma_somar(Histograma *destino, const Histograma *origem);
+
+// Retorna o percentil p (0-100) aproximado pelo limite superior da faixa
+long long histograma_percentil(const Histograma *h, double p);
+
+// Imprime uma linha "nome: n=... media=... p50=... p95=... p99=... max=..."
+void histograma_imprimir(FILE *saida, const char *nome, const Histograma *h);
+
+// Retorna o tempo monotônico atual em nanossegundos
+long long agora_ns(void);
+
+// Abre o destino dos relatórios de partida:
+// arquivo indicado pela variável de ambiente TEDAX_STATS (modo append) ou stderr
+FILE* abrir_saida_estatisticas(void);
+
+// Fecha o destino aberto por abrir_saida_estatisticas (não fecha stderr)
+void fechar_saida_estatisticas(FILE *saida);
+
+#endif // ESTATISTICAS_H
@@ -0,0 +1,49 @@
+#define _POSIX_C_SOURCE 200809L
+#include "aleatorio.h"
+#include <time.h>
+
+#define PCG_MULTIPLICADOR 6364136223846793005ULL
+
+// Prepara o fluxo número fluxo da semente (inicialização de referência do PCG)
+void aleatorio_semear(Aleatorio *a, uint64_t semente, uint64_t fluxo) {
+    a->estado = 0;
+    a->incremento = (fluxo << 1) | 1;
+    aleatorio_proximo(a);
+    a->estado += semente;
+    aleatorio_proximo(a);
+}
+
+// Próximo valor: avança a congruência linear e permuta o estado anterior
+// (xorshift e rotação pelos 5 bits altos)
+uint32_t aleatorio_proximo(Aleatorio *a) {
+    uint64_t anterior = a->estado;
+    a->estado = anterior * PCG_MULTIPLICADOR + a->incremento;
+    uint32_t misturado = (uint32_t)(((anterior >> 18) ^ anterior) >> 27);
+    uint32_t rotacao = (uint32_t)(anterior >> 59);
+    return (misturado >> rotacao) | (misturado << ((32 - rotacao) & 31));
+}
+
+// Inteiro uniforme em [0, limite): multiplica em 64 bits e usa a parte alta,
+// rejeitando a pequena faixa que daria viés (método de Lemire)
+uint32_t aleatorio_abaixo(Aleatorio *a, uint32_t limite) {
+    uint64_t produto = (uint64_t)aleatorio_proximo(a) * limite;
+    uint32_t parte_baixa = (uint32_t)produto;
+    if (parte_baixa < limite) {
+        uint32_t limiar = (uint32_t)(-limite) % limite;
+        while (parte_baixa < limiar) {
+            produto = (uint64_t)aleatorio_proximo(a) * limite;
+            parte_baixa = (uint32_t)produto;
+        }
+    }
+    return (uint32_t)(produto >> 32);
+}
+
+// Semente nova a partir dos relógios de parede e monotônico
+uint64_t aleatorio_semente_do_relogio(void) {
+    struct timespec parede, monotonico;
+    clock_gettime(CLOCK_REALTIME, &parede);
+    clock_gettime(CLOCK_MONOTONIC, &monotonico);
+    uint64_t semente = (uint64_t)parede.tv_sec * 1000000000ULL + (uint64_t)parede.tv_nsec;
+    semente ^= ((uint64_t)monotonico.tv_nsec << 32) | (uint64_t)monotonico.tv_sec;
+    return semente != 0 ? semente : 1;
+}
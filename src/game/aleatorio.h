@@ -0,0 +1,28 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+#include <stdint.h>
+
+// Gerador pseudoaleatório PCG32 (estado de 64 bits, saída de 32 bits)
+// Cada Aleatorio é um fluxo independente: a mesma semente com fluxos
+// diferentes dá sequências diferentes, e a mesma semente e fluxo repetem a
+// sequência bit a bit. Sem estado global: quem usa um fluxo é responsável por
+// não usá-lo de duas threads ao mesmo tempo.
+typedef struct {
+    uint64_t estado;
+    uint64_t incremento;        // ímpar; escolhe o fluxo
+} Aleatorio;
+
+// Prepara o fluxo número fluxo da semente
+void aleatorio_semear(Aleatorio *a, uint64_t semente, uint64_t fluxo);
+
+// Próximo valor de 32 bits
+uint32_t aleatorio_proximo(Aleatorio *a);
+
+// Inteiro uniforme em [0, limite) sem viés de módulo (limite > 0)
+uint32_t aleatorio_abaixo(Aleatorio *a, uint32_t limite);
+
+// Semente nova a partir do relógio, para partidas sem semente escolhida
+uint64_t aleatorio_semente_do_relogio(void);
+
+#endif // ALEATORIO_H
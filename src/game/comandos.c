@@ -0,0 +1,177 @@
+#include "comandos.h"
+#include <string.h>
+
+// Fila limitada de Dmitry Vyukov: cada célula tem um número de sequência e quem
+// envia reserva uma posição com compare-and-swap na cauda. Sem travas: enviar
+// nunca bloqueia, mesmo com a simulação ocupada.
+
+// Prepara a fila vazia
+void fila_comandos_inicializar(FilaComandos *fila) {
+    for (size_t i = 0; i < FILA_COMANDOS_CAPACIDADE; i++) {
+        atomic_init(&fila->celulas[i].sequencia, i);
+    }
+    atomic_init(&fila->cauda, 0);
+    fila->cabeca = 0;
+}
+
+// Envia um comando para a fila (qualquer thread)
+// Retorna 1 se enviou, 0 se a fila está cheia
+int fila_comandos_enviar(FilaComandos *fila, const Comando *comando) {
+    CelulaComando *celula;
+    size_t posicao = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+    
+    for (;;) {
+        celula = &fila->celulas[posicao & (FILA_COMANDOS_CAPACIDADE - 1)];
+        size_t sequencia = atomic_load_explicit(&celula->sequencia, memory_order_acquire);
+        long diferenca = (long)sequencia - (long)posicao;
+        
+        if (diferenca == 0) {
+            // Célula livre: tentar reservar a posição
+            if (atomic_compare_exchange_weak_explicit(&fila->cauda, &posicao, posicao + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diferenca < 0) {
+            return 0; // Fila cheia: a célula ainda não foi consumida
+        } else {
+            // Outra thread reservou esta posição: recarregar a cauda
+            posicao = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+        }
+    }
+    
+    celula->comando = *comando;
+    atomic_store_explicit(&celula->sequencia, posicao + 1, memory_order_release);
+    return 1;
+}
+
+// Retira o comando mais antigo da fila (só o consumidor)
+// Retorna 1 se havia comando, 0 se a fila está vazia
+int fila_comandos_receber(FilaComandos *fila, Comando *comando) {
+    CelulaComando *celula = &fila->celulas[fila->cabeca & (FILA_COMANDOS_CAPACIDADE - 1)];
+    size_t sequencia = atomic_load_explicit(&celula->sequencia, memory_order_acquire);
+    
+    if (sequencia != fila->cabeca + 1) {
+        return 0; // Vazia (ou o produtor ainda está copiando o comando)
+    }
+    
+    *comando = celula->comando;
+    atomic_store_explicit(&celula->sequencia, fila->cabeca + FILA_COMANDOS_CAPACIDADE,
+                          memory_order_release);
+    fila->cabeca++;
+    return 1;
+}
+
+// Interpreta o texto digitado no formato T1B1M1:ppp
+// Só valida os números de tedax e bancada; o módulo é procurado pelo ID
+// quando o comando é aplicado (simular_aplicar_comando)
+int interpretar_comando(const char *buffer, int qtd_tedax, int qtd_bancadas, Comando *cmd) {
+    // Inicializar valores como -1 (não especificado)
+    cmd->tedax_idx = -1;
+    cmd->bancada_idx = -1;
+    cmd->modulo_id = -1;
+    cmd->instrucao[0] = '\0';
+    cmd->tecla_ns = 0;
+    cmd->enter_ns = 0;
+    char *instrucao = cmd->instrucao;
+    
+    // Procurar por ':' que separa o comando da instrução
+    const char *separador = strchr(buffer, ':');
+    
+    if (!separador) {
+        // Se não há ':', tratar tudo como instrução (caso: apenas "ppp")
+        // Verificar se há algum T, B ou M no buffer - se houver, é formato inválido
+        int tem_comando = 0;
+        for (int i = 0; buffer[i] != '\0'; i++) {
+            if (buffer[i] == 'T' || buffer[i] == 't' || 
+                buffer[i] == 'B' || buffer[i] == 'b' || 
+                buffer[i] == 'M' || buffer[i] == 'm') {
+                tem_comando = 1;
+                break;
+            }
+        }
+        
+        if (tem_comando) {
+            return 0; // Formato inválido - tem T/B/M mas falta ':'
+        }
+        
+        // Apenas instrução, sem especificações
+        strncpy(instrucao, buffer, 15);
+        instrucao[15] = '\0';
+        return 1;
+    }
+    
+    // Copiar instrução (parte após ':')
+    strncpy(instrucao, separador + 1, 15);
+    instrucao[15] = '\0';
+    
+    // Se a parte antes do ':' está vazia (caso: ":ppp"), apenas instrução
+    int len_comando = separador - buffer;
+    if (len_comando == 0) {
+        return 1; // Apenas instrução, sem especificações
+    }
+    
+    // Processar parte antes do ':' (T1B1M1)
+    char comando[32];
+    if (len_comando >= (int)sizeof(comando)) {
+        return 0; // Comando longo demais
+    }
+    memcpy(comando, buffer, len_comando);
+    comando[len_comando] = '\0';
+    
+    // Fazer parsing do comando
+    int i = 0;
+    while (i < len_comando) {
+        if (comando[i] == 'T' || comando[i] == 't') {
+            // Ler número do tedax
+            i++;
+            int num = 0;
+            while (i < len_comando && comando[i] >= '0' && comando[i] <= '9') {
+                if (num < 100000) {
+                    num = num * 10 + (comando[i] - '0');
+                }
+                i++;
+            }
+            if (num >= 1 && num <= qtd_tedax) {
+                cmd->tedax_idx = num - 1; // Converter para índice (0-based)
+            } else {
+                return 0; // Tedax inválido
+            }
+        } else if (comando[i] == 'B' || comando[i] == 'b') {
+            // Ler número da bancada
+            i++;
+            int num = 0;
+            while (i < len_comando && comando[i] >= '0' && comando[i] <= '9') {
+                if (num < 100000) {
+                    num = num * 10 + (comando[i] - '0');
+                }
+                i++;
+            }
+            if (num >= 1 && num <= qtd_bancadas) {
+                cmd->bancada_idx = num - 1; // Converter para índice (0-based)
+            } else {
+                return 0; // Bancada inválida
+            }
+        } else if (comando[i] == 'M' || comando[i] == 'm') {
+            // Ler número do módulo (ID do módulo, não índice)
+            i++;
+            int num = 0;
+            while (i < len_comando && comando[i] >= '0' && comando[i] <= '9') {
+                if (num < 100000) {
+                    num = num * 10 + (comando[i] - '0');
+                }
+                i++;
+            }
+            if (num >= 1) {
+                cmd->modulo_id = num; // Procurado pelo ID ao aplicar o comando
+            } else {
+                return 0; // Módulo inválido
+            }
+        } else {
+            i++; // Ignorar caracteres desconhecidos
+        }
+    }
+    
+    return 1; // Sucesso
+}
+
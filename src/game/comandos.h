@@ -0,0 +1,51 @@
+#ifndef COMANDOS_H
+#define COMANDOS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+// Comando do coordenador já interpretado (formato T1B1M1:ppp)
+// Campos não especificados ficam em -1 e recebem os defaults ao ser aplicado
+typedef struct {
+    int tedax_idx;              // índice do tedax (0-based), ou -1
+    int bancada_idx;            // índice da bancada (0-based), ou -1
+    int modulo_id;              // ID do módulo (como aparece na tela), ou -1
+    char instrucao[16];         // instrução a ser executada
+    long long tecla_ns;         // primeira tecla do comando (agora_ns), ou 0 se não medido
+    long long enter_ns;         // Enter que enviou o comando, ou 0 se não medido
+} Comando;
+
+// Capacidade da fila de comandos (potência de 2)
+#define FILA_COMANDOS_CAPACIDADE 64
+
+// Célula da fila: o número de sequência diz se ela está livre para quem envia
+// (sequencia == posição) ou pronta para quem recebe (sequencia == posição + 1)
+typedef struct {
+    atomic_size_t sequencia;
+    Comando comando;
+} CelulaComando;
+
+// Fila de comandos sem travas, limitada, com vários produtores e um consumidor
+// Qualquer thread pode enviar; só a thread da simulação recebe
+typedef struct {
+    CelulaComando celulas[FILA_COMANDOS_CAPACIDADE];
+    atomic_size_t cauda;        // próxima posição a ser reservada por quem envia
+    size_t cabeca;              // próxima posição a ser lida (só o consumidor mexe)
+} FilaComandos;
+
+// Prepara a fila vazia
+void fila_comandos_inicializar(FilaComandos *fila);
+
+// Envia um comando para a fila (qualquer thread)
+// Retorna 1 se enviou, 0 se a fila está cheia
+int fila_comandos_enviar(FilaComandos *fila, const Comando *comando);
+
+// Retira o comando mais antigo da fila (só o consumidor)
+// Retorna 1 se havia comando, 0 se a fila está vazia
+int fila_comandos_receber(FilaComandos *fila, Comando *comando);
+
+// Interpreta o texto digitado no formato T1B1M1:ppp, sem consultar o estado do jogo
+// Retorna 1 se o formato é válido, 0 caso contrário
+int interpretar_comando(const char *buffer, int qtd_tedax, int qtd_bancadas, Comando *comando);
+
+#endif // COMANDOS_H
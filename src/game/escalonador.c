@@ -0,0 +1,375 @@
+#define _POSIX_C_SOURCE 200809L
+#include "escalonador.h"
+#include "simulacao.h"
+#include "retrato.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+// Cada tedax tem sempre um único passo agendado: um prazo no heap ou uma
+// TAREFA_PASSO num deque. Um trabalhador sem tarefas rouba do topo do deque de
+// outro; sem nada para roubar, colhe os prazos vencidos do heap para o próprio
+// deque (acordando os demais para roubarem se colheu mais de um) ou dorme até
+// o próximo prazo. Um passo que libera uma bancada com tedax em espera empilha
+// uma TAREFA_VERIFICAR para ele, executada logo em seguida pelo mesmo
+// trabalhador: a bancada troca de mãos sem esperar o próximo segundo.
+//
+// Ordem das travas: trava_prazos -> trava de um deque. As travas do jogo só são
+// adquiridas pelo motor de simulação, sem nenhuma trava do escalonador travada.
+
+// ============================================================================
+// DEQUE DE TAREFAS
+// ============================================================================
+
+static int deque_inicializar(DequeTarefas *d, int capacidade) {
+    d->tarefas = malloc(sizeof(TarefaTedax) * capacidade);
+    if (!d->tarefas) {
+        return 0;
+    }
+    d->capacidade = capacidade;
+    d->topo = 0;
+    d->base = 0;
+    trava_inicializar(&d->trava);
+    return 1;
+}
+
+static void deque_finalizar(DequeTarefas *d) {
+    trava_destruir(&d->trava);
+    free(d->tarefas);
+    d->tarefas = NULL;
+}
+
+// Empilha na base (só o dono); retorna 0 se o deque está cheio
+static int deque_empilhar(DequeTarefas *d, const TarefaTedax *tarefa) {
+    int empilhou = 0;
+    trava_travar(&d->trava);
+    if (d->base - d->topo < d->capacidade) {
+        d->tarefas[d->base & (d->capacidade - 1)] = *tarefa;
+        d->base++;
+        empilhou = 1;
+    }
+    trava_destravar(&d->trava);
+    return empilhou;
+}
+
+// Desempilha da base a tarefa mais recente (só o dono)
+static int deque_desempilhar(DequeTarefas *d, TarefaTedax *tarefa) {
+    int desempilhou = 0;
+    trava_travar(&d->trava);
+    if (d->base > d->topo) {
+        d->base--;
+        *tarefa = d->tarefas[d->base & (d->capacidade - 1)];
+        desempilhou = 1;
+    }
+    trava_destravar(&d->trava);
+    return desempilhou;
+}
+
+// Há tarefas no deque? (qualquer trabalhador)
+static int deque_tem_tarefas(DequeTarefas *d) {
+    trava_travar(&d->trava);
+    int tem = d->base > d->topo;
+    trava_destravar(&d->trava);
+    return tem;
+}
+
+// Tira do topo a tarefa mais antiga (outros trabalhadores)
+static int deque_roubar(DequeTarefas *d, TarefaTedax *tarefa) {
+    int roubou = 0;
+    trava_travar(&d->trava);
+    if (d->base > d->topo) {
+        *tarefa = d->tarefas[d->topo & (d->capacidade - 1)];
+        d->topo++;
+        roubou = 1;
+    }
+    trava_destravar(&d->trava);
+    return roubou;
+}
+
+// ============================================================================
+// HEAP DE PRAZOS
+// NOTA: Funções chamadas com trava_prazos já travada
+// ============================================================================
+
+static void trocar_prazos(PrazoTedax *a, PrazoTedax *b) {
+    PrazoTedax tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void inserir_prazo(Escalonador *esc, long long prazo_ns, int tedax_idx) {
+    int i = esc->qtd_prazos++;
+    esc->prazos[i].prazo_ns = prazo_ns;
+    esc->prazos[i].tedax_idx = tedax_idx;
+    while (i > 0 && esc->prazos[(i - 1) / 2].prazo_ns > esc->prazos[i].prazo_ns) {
+        trocar_prazos(&esc->prazos[(i - 1) / 2], &esc->prazos[i]);
+        i = (i - 1) / 2;
+    }
+}
+
+static PrazoTedax remover_primeiro_prazo(Escalonador *esc) {
+    PrazoTedax primeiro = esc->prazos[0];
+    esc->prazos[0] = esc->prazos[--esc->qtd_prazos];
+    int i = 0;
+    for (;;) {
+        int menor = i;
+        int esq = 2 * i + 1;
+        int dir = 2 * i + 2;
+        if (esq < esc->qtd_prazos && esc->prazos[esq].prazo_ns < esc->prazos[menor].prazo_ns) {
+            menor = esq;
+        }
+        if (dir < esc->qtd_prazos && esc->prazos[dir].prazo_ns < esc->prazos[menor].prazo_ns) {
+            menor = dir;
+        }
+        if (menor == i) {
+            break;
+        }
+        trocar_prazos(&esc->prazos[i], &esc->prazos[menor]);
+        i = menor;
+    }
+    return primeiro;
+}
+
+// ============================================================================
+// TRABALHADORES
+// ============================================================================
+
+// Executa uma tarefa de tedax e reagenda o próximo passo
+static void executar_tarefa(Escalonador *esc, Trabalhador *t, const TarefaTedax *tarefa) {
+    GameState *g = esc->g;
+    t->executadas++;
+
+    if (tarefa->tipo == TAREFA_VERIFICAR) {
+        simular_verificar_espera_tedax(g, tarefa->tedax_idx);
+        return;
+    }
+
+    long long atraso = agora_ns() - tarefa->prazo_ns;
+    histograma_registrar(&t->atraso, atraso);
+    if (atraso >= ESCALONADOR_PERIODO_NS) {
+        t->estourados++;
+    }
+
+    int acordar_idx = simular_passo_tedax(g, tarefa->tedax_idx);
+
+    // Próximo passo sempre um período depois do prazo deste (não de agora): o
+    // cronômetro do módulo não escorrega quando um passo atrasa, e um tedax
+    // atrasado mais de um período recupera os passos perdidos em seguida
+    long long proximo_ns = tarefa->prazo_ns + ESCALONADOR_PERIODO_NS;
+    trava_travar(&esc->trava_prazos);
+    inserir_prazo(esc, proximo_ns, tarefa->tedax_idx);
+    trava_destravar(&esc->trava_prazos);
+
+    // Tedax em espera pela bancada liberada: ocupar já, neste trabalhador
+    if (acordar_idx >= 0) {
+        TarefaTedax verificar = { acordar_idx, TAREFA_VERIFICAR, 0 };
+        if (!deque_empilhar(&t->deque, &verificar)) {
+            simular_verificar_espera_tedax(g, acordar_idx);
+        }
+    }
+}
+
+// Tenta roubar uma tarefa dos outros trabalhadores, começando pelo seguinte
+static int roubar_tarefa(Escalonador *esc, Trabalhador *t, TarefaTedax *tarefa) {
+    for (int i = 1; i < esc->qtd_trabalhadores; i++) {
+        Trabalhador *vitima = &esc->trabalhadores[(t->indice + i) % esc->qtd_trabalhadores];
+        if (deque_roubar(&vitima->deque, tarefa)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Algum deque tem tarefas para roubar? (com trava_prazos travada)
+static int ha_tarefas_para_roubar(Escalonador *esc) {
+    for (int i = 0; i < esc->qtd_trabalhadores; i++) {
+        if (deque_tem_tarefas(&esc->trabalhadores[i].deque)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Move os passos vencidos do heap para o deque do trabalhador; se não houver
+// nenhum, dorme até o próximo prazo (ou até alguém colher vários e acordá-lo)
+// NOTA: Quem colhe empilha e acorda os outros com trava_prazos travada. Entre
+// o roubo que falhou e esta função outro trabalhador pode ter colhido um lote
+// e já ter acordado todo mundo; por isso os deques são olhados de novo sob
+// trava_prazos antes de dormir, senão as tarefas ficariam paradas num deque
+// com este trabalhador dormindo até o próximo prazo.
+static void colher_ou_dormir(Escalonador *esc, Trabalhador *t) {
+    trava_travar(&esc->trava_prazos);
+
+    long long agora = agora_ns();
+    int colhidas = 0;
+    while (esc->qtd_prazos > 0 && esc->prazos[0].prazo_ns <= agora) {
+        PrazoTedax prazo = remover_primeiro_prazo(esc);
+        TarefaTedax tarefa = { prazo.tedax_idx, TAREFA_PASSO, prazo.prazo_ns };
+        if (!deque_empilhar(&t->deque, &tarefa)) {
+            inserir_prazo(esc, prazo.prazo_ns, prazo.tedax_idx);
+            break;
+        }
+        colhidas++;
+    }
+
+    if (colhidas > 1) {
+        // Vários tedax venceram juntos: acordar os outros para dividir o lote
+        pthread_cond_broadcast(&esc->cond_trabalho);
+    } else if (colhidas == 0 && atomic_load(&esc->rodando) && !ha_tarefas_para_roubar(esc)) {
+        long long prazo_ns = esc->qtd_prazos > 0 ? esc->prazos[0].prazo_ns
+                                                 : agora + ESCALONADOR_PERIODO_NS;
+        struct timespec prazo;
+        prazo.tv_sec = prazo_ns / 1000000000LL;
+        prazo.tv_nsec = prazo_ns % 1000000000LL;
+        trava_esperar_condicao(&esc->trava_prazos, &esc->cond_trabalho, &prazo);
+        atomic_fetch_add_explicit(&esc->g->despertares, 1, memory_order_relaxed);
+    }
+
+    trava_destravar(&esc->trava_prazos);
+}
+
+static void* executar_trabalhador(void *arg) {
+    Trabalhador *t = (Trabalhador*)arg;
+    Escalonador *esc = t->esc;
+    GameState *g = esc->g;
+    int publicar = 0;
+    trava_definir_papel(PAPEL_TEDAX);
+
+    while (atomic_load(&esc->rodando) && g->jogo_rodando && !g->jogo_terminou) {
+        TarefaTedax tarefa;
+        if (deque_desempilhar(&t->deque, &tarefa)) {
+            executar_tarefa(esc, t, &tarefa);
+            publicar = 1;
+            continue;
+        }
+        if (roubar_tarefa(esc, t, &tarefa)) {
+            t->roubadas++;
+            executar_tarefa(esc, t, &tarefa);
+            publicar = 1;
+            continue;
+        }
+
+        // Sem tarefas: publicar o resultado do lote antes de colher ou dormir
+        if (publicar) {
+            publicar_retrato_tela(g, esc->buffer_instrucao);
+            publicar = 0;
+        }
+        colher_ou_dormir(esc, t);
+    }
+
+    return NULL;
+}
+
+// ============================================================================
+// INÍCIO E FIM
+// ============================================================================
+
+// Libera deques, heap e sincronização (trabalhadores já parados)
+static void liberar_escalonador(Escalonador *esc, int qtd_deques) {
+    for (int i = 0; i < qtd_deques; i++) {
+        deque_finalizar(&esc->trabalhadores[i].deque);
+    }
+    free(esc->prazos);
+    esc->prazos = NULL;
+    pthread_cond_destroy(&esc->cond_trabalho);
+    trava_destruir(&esc->trava_prazos);
+}
+
+// Inicia os trabalhadores e agenda o primeiro passo de todos os tedax
+int escalonador_iniciar(Escalonador *esc, GameState *g, int qtd_trabalhadores,
+                        const char *buffer_instrucao) {
+    if (qtd_trabalhadores <= 0) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        qtd_trabalhadores = nucleos > 0 ? (int)nucleos : 1;
+    }
+    if (qtd_trabalhadores > ESCALONADOR_MAX_TRABALHADORES) {
+        qtd_trabalhadores = ESCALONADOR_MAX_TRABALHADORES;
+    }
+    if (qtd_trabalhadores > g->qtd_tedax) {
+        qtd_trabalhadores = g->qtd_tedax > 0 ? g->qtd_tedax : 1;
+    }
+
+    esc->g = g;
+    esc->buffer_instrucao = buffer_instrucao;
+    esc->qtd_trabalhadores = qtd_trabalhadores;
+    esc->qtd_prazos = 0;
+    atomic_init(&esc->rodando, 1);
+    trava_inicializar(&esc->trava_prazos);
+    pthread_condattr_t attr_cond;
+    pthread_condattr_init(&attr_cond);
+    pthread_condattr_setclock(&attr_cond, CLOCK_MONOTONIC);
+    pthread_cond_init(&esc->cond_trabalho, &attr_cond);
+    pthread_condattr_destroy(&attr_cond);
+
+    // Cabem no deque todas as tarefas que podem existir ao mesmo tempo:
+    // um passo e uma verificação por tedax
+    int capacidade = 16;
+    while (capacidade < 2 * g->qtd_tedax) {
+        capacidade *= 2;
+    }
+
+    esc->prazos = malloc(sizeof(PrazoTedax) * (g->qtd_tedax > 0 ? g->qtd_tedax : 1));
+    if (!esc->prazos) {
+        liberar_escalonador(esc, 0);
+        return 0;
+    }
+    for (int i = 0; i < qtd_trabalhadores; i++) {
+        Trabalhador *t = &esc->trabalhadores[i];
+        t->esc = esc;
+        t->indice = i;
+        t->executadas = 0;
+        t->roubadas = 0;
+        t->estourados = 0;
+        histograma_zerar(&t->atraso);
+        if (!deque_inicializar(&t->deque, capacidade)) {
+            liberar_escalonador(esc, i);
+            return 0;
+        }
+    }
+
+    // Primeiro passo de todos os tedax agora
+    long long agora = agora_ns();
+    for (int i = 0; i < g->qtd_tedax; i++) {
+        inserir_prazo(esc, agora, i);
+    }
+
+    // Se alguma thread não puder ser criada, seguir com as que foram (o deque
+    // dos que faltaram fica vazio e continua visível para os ladrões)
+    esc->qtd_threads = 0;
+    for (int i = 0; i < qtd_trabalhadores; i++) {
+        if (pthread_create(&esc->trabalhadores[i].thread, NULL, executar_trabalhador,
+                           &esc->trabalhadores[i]) != 0) {
+            break;
+        }
+        esc->qtd_threads++;
+    }
+    if (esc->qtd_threads == 0) {
+        liberar_escalonador(esc, qtd_trabalhadores);
+        return 0;
+    }
+    return 1;
+}
+
+// Para e aguarda os trabalhadores, guarda os contadores em g e libera a memória
+void escalonador_parar(Escalonador *esc) {
+    atomic_store(&esc->rodando, 0);
+    trava_travar(&esc->trava_prazos);
+    pthread_cond_broadcast(&esc->cond_trabalho);
+    trava_destravar(&esc->trava_prazos);
+
+    GameState *g = esc->g;
+    g->trabalhadores_tedax = esc->qtd_threads;
+    g->tarefas_tedax = 0;
+    g->tarefas_roubadas = 0;
+    g->passos_tedax_estourados = 0;
+    histograma_zerar(&g->hist_atraso_tedax);
+    for (int i = 0; i < esc->qtd_threads; i++) {
+        pthread_join(esc->trabalhadores[i].thread, NULL);
+        g->tarefas_tedax += esc->trabalhadores[i].executadas;
+        g->tarefas_roubadas += esc->trabalhadores[i].roubadas;
+        g->passos_tedax_estourados += esc->trabalhadores[i].estourados;
+        histograma_somar(&g->hist_atraso_tedax, &esc->trabalhadores[i].atraso);
+    }
+
+    liberar_escalonador(esc, esc->qtd_trabalhadores);
+}
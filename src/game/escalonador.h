@@ -0,0 +1,81 @@
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+#include "game.h"
+
+// Escalonador M:N dos tedax: cada tedax é uma máquina de estados (Tedax +
+// simular_passo_tedax) executada como tarefa por um pequeno conjunto de
+// trabalhadores, em vez de uma thread dormindo por tedax. Cada trabalhador tem
+// seu deque de tarefas; quem fica sem trabalho rouba do deque de outro.
+
+#define ESCALONADOR_MAX_TRABALHADORES 8
+
+// Período do passo de cada tedax (1 segundo de jogo)
+#define ESCALONADOR_PERIODO_NS 1000000000LL
+
+typedef enum {
+    TAREFA_PASSO,               // passo de 1 segundo do tedax (simular_passo_tedax)
+    TAREFA_VERIFICAR            // bancada liberada para o tedax em espera
+} TipoTarefaTedax;
+
+typedef struct {
+    int tedax_idx;
+    TipoTarefaTedax tipo;
+    long long prazo_ns;         // TAREFA_PASSO: prazo em que o passo venceu
+} TarefaTedax;
+
+// Deque de tarefas de um trabalhador: o dono empilha e desempilha na base,
+// os ladrões tiram do topo (a tarefa mais antiga)
+typedef struct {
+    TarefaTedax *tarefas;
+    int capacidade;             // potência de 2
+    long topo;
+    long base;
+    Trava trava;
+} DequeTarefas;
+
+// Prazo do próximo passo de um tedax (entrada do heap de prazos)
+typedef struct {
+    long long prazo_ns;
+    int tedax_idx;
+} PrazoTedax;
+
+typedef struct Escalonador Escalonador;
+
+typedef struct {
+    Escalonador *esc;
+    int indice;
+    pthread_t thread;
+    DequeTarefas deque;
+    long executadas;            // tarefas executadas por este trabalhador
+    long roubadas;              // das quais roubadas de outro trabalhador
+    long estourados;            // passos que começaram um período inteiro atrasados
+    Histograma atraso;          // início do passo - prazo do passo
+} Trabalhador;
+
+struct Escalonador {
+    GameState *g;
+    const char *buffer_instrucao; // buffer do coordenador (para publicar o retrato)
+    Trabalhador trabalhadores[ESCALONADOR_MAX_TRABALHADORES];
+    int qtd_trabalhadores;      // trabalhadores com deque
+    int qtd_threads;            // dos quais com thread rodando
+
+    // Heap mínimo dos prazos dos passos: cada tedax tem exatamente um prazo no
+    // heap ou uma TAREFA_PASSO em algum deque
+    PrazoTedax *prazos;
+    int qtd_prazos;
+    Trava trava_prazos;         // protege o heap; mutex de cond_trabalho
+    pthread_cond_t cond_trabalho; // trabalhadores ociosos dormem aqui (relógio monotônico)
+    atomic_int rodando;
+};
+
+// Inicia os trabalhadores (qtd_trabalhadores <= 0 usa o número de núcleos) e
+// agenda o primeiro passo de todos os tedax para agora
+// Retorna 1 se iniciou, 0 se faltou memória ou não conseguiu criar as threads
+int escalonador_iniciar(Escalonador *esc, GameState *g, int qtd_trabalhadores,
+                        const char *buffer_instrucao);
+
+// Para e aguarda os trabalhadores, guarda os contadores em g e libera a memória
+void escalonador_parar(Escalonador *esc);
+
+#endif // ESCALONADOR_H
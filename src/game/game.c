@@ -1,45 +1,73 @@
+#define _POSIX_C_SOURCE 200809L
 #include "game.h"
-#include "../ui/ui.h"
+#include "retrato.h"
+#include "pool.h"
+#include "indice.h"
+#include "ordem.h"
+#include "simulacao.h"
 #include "../fases/fases.h"
 #include "../modulos/modulos.h"
+#include "../estatisticas/estatisticas.h"
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <unistd.h>
-#include <errno.h>
-#include <ncurses.h>
 
 // Inicializa o estado do jogo com a dificuldade escolhida
-void inicializar_jogo(GameState *g, Dificuldade dificuldade, int num_tedax, int num_bancadas) {
+void inicializar_jogo(GameState *g, Dificuldade dificuldade, int num_tedax, int num_bancadas,
+                      uint64_t semente) {
     // Obter configuração da fase
     const ConfigFase *config = obter_config_fase(dificuldade);
     
     // Validar parâmetros (usar valores da configuração se não especificados)
     if (num_tedax < 1) num_tedax = config->num_tedax;
-    if (num_tedax > 5) num_tedax = 5;
+    if (num_tedax > MAX_TEDAX) num_tedax = MAX_TEDAX;
     if (num_bancadas < 1) num_bancadas = config->num_bancadas;
-    if (num_bancadas > 5) num_bancadas = 5;
+    if (num_bancadas > MAX_BANCADAS) num_bancadas = MAX_BANCADAS;
     
     g->dificuldade = dificuldade;
     
     // Usar configurações da fase
     g->tempo_total_partida = config->tempo_total_partida;
     g->tempo_restante = g->tempo_total_partida;
+    pool_modulos_inicializar(&g->modulos);
     g->qtd_modulos = 0;
+    g->modulos_reciclados = 0;
+    for (int i = 0; i < 3; i++) {
+        pool_lista_inicializar(&g->modulos_por_estado[i]);
+    }
+    indice_modulos_limpar(&g->indice_modulos);
+    ordem_modulos_inicializar(&g->ordem_modulos);
+    g->ultimo_resolvido_oculto = MODULO_NENHUM;
+    g->resolvidos_ocultos = 0;
     g->proximo_id_modulo = 1;
+    g->qtd_reserva_modulos = 0;
     g->modulos_necessarios = config->modulos_necessarios;
     g->intervalo_geracao = config->intervalo_geracao;
     g->max_modulos = config->modulos_necessarios; // máximo = necessário para vencer
     
+    // Tedax e bancadas são alocados por partida (até MAX_TEDAX/MAX_BANCADAS)
+    g->tedax = calloc(num_tedax, sizeof(Tedax));
+    g->bancadas = calloc(num_bancadas, sizeof(Bancada));
+    if (!g->tedax || !g->bancadas) {
+        fprintf(stderr, "Sem memoria para %d tedax e %d bancadas\n", num_tedax, num_bancadas);
+        exit(1);
+    }
+    
     // Inicializar múltiplos tedax
     g->qtd_tedax = num_tedax;
     for (int i = 0; i < num_tedax; i++) {
         g->tedax[i].id = i + 1;
         g->tedax[i].estado = TEDAX_LIVRE;
-        g->tedax[i].modulo_atual = -1;
+        g->tedax[i].modulo_atual = MODULO_NENHUM;
         g->tedax[i].bancada_atual = -1;
         g->tedax[i].qtd_fila = 0; // Inicializar fila vazia
-        g->tedax[i].fila_modulos[0] = -1;
+        g->tedax[i].fila_modulos[0] = MODULO_NENHUM;
+        g->tedax[i].comando_enter_ns = 0;
+        g->tedax[i].fila_enter_ns = 0;
+        g->tedax[i].estado_desde_ms = 0;
+        memset(g->tedax[i].tempo_estado_ms, 0, sizeof(g->tedax[i].tempo_estado_ms));
+        g->tedax[i].qtd_esperas = 0;
+        g->tedax[i].espera_max_ms = 0;
+        trava_inicializar(&g->tedax[i].trava);
     }
     
     // Inicializar múltiplas bancadas
@@ -49,103 +77,150 @@ void inicializar_jogo(GameState *g, Dificuldade dificuldade, int num_tedax, int
         g->bancadas[i].estado = BANCADA_LIVRE;
         g->bancadas[i].tedax_ocupando = -1;
         g->bancadas[i].tedax_esperando = -1;
+        g->bancadas[i].liberada_ns = 0;
+        g->bancadas[i].ocupada_desde_ms = 0;
+        g->bancadas[i].tempo_ocupada_ms = 0;
+        trava_inicializar(&g->bancadas[i].trava);
     }
     
-    // Inicializar random seed
-    srand(time(NULL));
+    // Semente e fluxos dos sorteios da partida
+    g->semente = semente != 0 ? semente : aleatorio_semente_do_relogio();
+    aleatorio_semear(&g->aleatorio_mural, g->semente, FLUXO_MURAL);
+    aleatorio_semear(&g->aleatorio_modulos, g->semente, FLUXO_MODULOS);
     
     g->ticks_desde_ultimo_modulo = 0;
     g->jogo_rodando = 1;
     g->jogo_terminou = 0;
     g->mensagem_erro[0] = '\0'; // Inicializar mensagem de erro vazia
+    g->visao_modulos.filtro_tipo = -1;
+    g->visao_modulos.filtro_estado = -1;
+    g->visao_modulos.primeira_linha = 0;
+    g->visao_modulos.ultima_primeira_linha = 0;
+    atomic_init(&g->linhas_modulos_tela, RETRATO_MAX_MODULOS); // até o primeiro quadro
     g->erros_cometidos = 0; // Inicializar contador de erros
-    
-    // Inicializar mutex e condition variables
-    pthread_mutex_init(&g->mutex_jogo, NULL);
+    g->gravacao = NULL;
+    
+    // Inicializar relógio do motor de simulação
+    g->sim_acumulado_ms = 0;
+    g->sim_ticks = 0;
+    
+    // Inicializar métricas da partida
+    g->modo_reator = 0;
+    g->modo_threads = 0;
+    atomic_init(&g->despertares, 0);
+    g->inicio_ns = agora_ns();
+    g->fim_ns = 0;
+    histograma_zerar(&g->hist_handoff_bancada);
+    histograma_zerar(&g->hist_pendente);
+    g->tecla_comando_ns = 0;
+    g->ultima_tecla_ns = 0;
+    g->ultimo_enter_ns = 0;
+    g->quadro_tecla_ns = 0;
+    g->quadro_enter_ns = 0;
+    histograma_zerar(&g->hist_digitacao);
+    histograma_zerar(&g->hist_enter_aplicado);
+    histograma_zerar(&g->hist_enter_bancada);
+    histograma_zerar(&g->hist_tecla_quadro);
+    histograma_zerar(&g->hist_enter_quadro);
+    g->quadros_desenhados = 0;
+    g->quadros_contados = 0;
+    g->bytes_tela = 0;
+    g->bytes_quadro_max = 0;
+    g->trabalhadores_tedax = 0;
+    g->tarefas_tedax = 0;
+    g->tarefas_roubadas = 0;
+    ritmo_iniciar(&g->ritmo_relogio, PERIODO_RELOGIO_NS);
+    ritmo_iniciar(&g->ritmo_mural, PERIODO_MURAL_NS);
+    histograma_zerar(&g->hist_atraso_tedax);
+    g->passos_tedax_estourados = 0;
+    
+    // Inicializar travas e condition variables
+    trava_inicializar(&g->trava_modulos);
+    trava_inicializar(&g->trava_ui);
+    inicializar_retratos_tela(&g->tela);
+    fila_comandos_inicializar(&g->comandos);
+    sem_init(&g->sem_comandos, 0, 0);
+    g->pipe_despertar[0] = -1;
+    g->pipe_despertar[1] = -1;
     pthread_cond_init(&g->cond_modulo_disponivel, NULL);
-    pthread_cond_init(&g->cond_bancada_disponivel, NULL);
-    pthread_cond_init(&g->cond_tela_atualizada, NULL);
+    trava_inicializar(&g->trava_quadro);
+    pthread_condattr_t attr_cond;
+    pthread_condattr_init(&attr_cond);
+    pthread_condattr_setclock(&attr_cond, CLOCK_MONOTONIC);
+    pthread_cond_init(&g->cond_tela_atualizada, &attr_cond);
+    pthread_condattr_destroy(&attr_cond);
+    g->fps_maximo = FPS_MAXIMO_PADRAO;
     
     // Gerar módulos iniciais baseado na configuração da fase
-    pthread_mutex_lock(&g->mutex_jogo);
+    trava_travar(&g->trava_modulos);
     for (int i = 0; i < config->modulos_iniciais; i++) {
         gerar_novo_modulo(g);
     }
-    pthread_mutex_unlock(&g->mutex_jogo);
+    trava_destravar(&g->trava_modulos);
 }
 
 // Finaliza o jogo e libera recursos
 void finalizar_jogo(GameState *g) {
     g->jogo_rodando = 0;
     
-    // Destruir mutex e condition variables
-    pthread_mutex_destroy(&g->mutex_jogo);
+    pool_modulos_finalizar(&g->modulos);
+    ordem_modulos_finalizar(&g->ordem_modulos);
+    
+    // Destruir travas e condition variables
+    trava_destruir(&g->trava_modulos);
+    trava_destruir(&g->trava_ui);
+    finalizar_retratos_tela(&g->tela);
+    sem_destroy(&g->sem_comandos);
     pthread_cond_destroy(&g->cond_modulo_disponivel);
-    pthread_cond_destroy(&g->cond_bancada_disponivel);
     pthread_cond_destroy(&g->cond_tela_atualizada);
+    trava_destruir(&g->trava_quadro);
+    for (int i = 0; i < g->qtd_tedax; i++) {
+        trava_destruir(&g->tedax[i].trava);
+    }
+    for (int i = 0; i < g->qtd_bancadas; i++) {
+        trava_destruir(&g->bancadas[i].trava);
+    }
+    free(g->tedax);
+    free(g->bancadas);
+    g->tedax = NULL;
+    g->bancadas = NULL;
 }
 
 // Gera um novo módulo e adiciona ao jogo
-// NOTA: Deve ser chamada com mutex_jogo já travado
+// NOTA: Deve ser chamada com trava_modulos já travada
 void gerar_novo_modulo(GameState *g) {
-    if (g->qtd_modulos >= 100) {
-        return; // Limite máximo de módulos atingido
+    HandleModulo handle = pool_modulos_alocar(&g->modulos);
+    if (handle == MODULO_NENHUM) {
+        return; // Pool cheio: limite de módulos vivos atingido
     }
     
-    Modulo *novo = &g->modulos[g->qtd_modulos];
+    PoolModulos *pool = &g->modulos;
+    Modulo *novo = pool_modulos_obter(pool, handle);
+    int slot = pool_modulos_slot(pool, handle);
+    
+    // Enigma: da reserva gerada em lote pelo mural, ou sorteado aqui se ela acabou
+    if (g->qtd_reserva_modulos > 0) {
+        *novo = g->reserva_modulos[--g->qtd_reserva_modulos];
+    } else {
+        gerar_modulo_aleatorio(novo, g->dificuldade, &g->aleatorio_modulos);
+    }
     
     // Atribuir ID
     novo->id = g->proximo_id_modulo++;
     
     // Obter configuração da fase para tempo de execução
     const ConfigFase *config = obter_config_fase(g->dificuldade);
-    novo->tempo_total = config->tempo_minimo_execucao + (rand() % (config->tempo_variacao_execucao + 1));
-    novo->tempo_restante = novo->tempo_total;
-    
-    // Escolher tipo de módulo aleatoriamente com pesos por dificuldade
-    // fácil: 40% fios, 40% botão, 20% hash
-    // médio: 40% fios, 30% botão, 30% hash
-    // difícil: 40% fios, 20% botão, 40% hash
-    int tipo_aleatorio = rand() % 100;
-    switch (g->dificuldade) {
-        case DIFICULDADE_FACIL:
-            if (tipo_aleatorio < 40) {
-                gerar_modulo_fios(novo, g->dificuldade);
-            } else if (tipo_aleatorio < 80) {
-                gerar_modulo_botao(novo, g->dificuldade);
-            } else {
-                gerar_modulo_senha(novo, g->dificuldade);
-            }
-            break;
-        case DIFICULDADE_MEDIO:
-            if (tipo_aleatorio < 40) {
-                gerar_modulo_fios(novo, g->dificuldade);
-            } else if (tipo_aleatorio < 70) {
-                gerar_modulo_botao(novo, g->dificuldade);
-            } else {
-                gerar_modulo_senha(novo, g->dificuldade);
-            }
-            break;
-        case DIFICULDADE_DIFICIL:
-            if (tipo_aleatorio < 40) {
-                gerar_modulo_fios(novo, g->dificuldade);
-            } else if (tipo_aleatorio < 60) {
-                gerar_modulo_botao(novo, g->dificuldade);
-            } else {
-                gerar_modulo_senha(novo, g->dificuldade);
-            }
-            break;
-        default:
-            gerar_modulo_botao(novo, g->dificuldade);
-            break;
-    }
-    
-    // Limpar instrução digitada
-    novo->instrucao_digitada[0] = '\0';
+    pool->tempo_total[slot] = config->tempo_minimo_execucao + aleatorio_abaixo(&g->aleatorio_modulos, config->tempo_variacao_execucao + 1);
+    pool->tempo_restante[slot] = pool->tempo_total[slot];
     
     // Estado inicial: pendente
-    novo->estado = MOD_PENDENTE;
-    novo->tempo_desde_resolvido = -1; // -1 significa não resolvido ainda
+    pool->estado[slot] = MOD_PENDENTE;
+    pool->tipo[slot] = (unsigned char)novo->tipo;
+    pool->instante_resolvido[slot] = -1; // -1 significa não resolvido ainda
+    pool->pendente_desde_ms[slot] = (int)instante_partida_ms(g);
+    pool_lista_inserir(pool, &g->modulos_por_estado[MOD_PENDENTE], handle);
+    indice_modulos_inserir(&g->indice_modulos, novo->id, handle);
+    ordem_modulos_inserir(&g->ordem_modulos, slot, (TipoModulo)pool->tipo[slot], MOD_PENDENTE);
     
     g->qtd_modulos++;
     
@@ -153,37 +228,230 @@ void gerar_novo_modulo(GameState *g) {
     pthread_cond_broadcast(&g->cond_modulo_disponivel);
 }
 
-// Conta quantos módulos foram resolvidos
-// NOTA: Deve ser chamada com mutex_jogo já travado
-int contar_modulos_resolvidos(const GameState *g) {
-    int resolvidos = 0;
-    for (int i = 0; i < g->qtd_modulos; i++) {
-        if (g->modulos[i].estado == MOD_RESOLVIDO) {
-            resolvidos++;
-        }
+// Repõe a reserva de módulos pré-gerados
+// NOTA: Não deve ser chamada com trava_modulos travada
+void repor_reserva_modulos(GameState *g) {
+    trava_travar(&g->trava_modulos);
+    int faltam = RESERVA_MODULOS - g->qtd_reserva_modulos;
+    trava_destravar(&g->trava_modulos);
+    if (faltam < RESERVA_MODULOS / 2) {
+        return;
+    }
+    
+    // O sorteio dos enigmas (a parte cara) acontece sem a trava
+    Modulo lote[RESERVA_MODULOS];
+    gerar_lote_modulos(lote, faltam, g->dificuldade, &g->aleatorio_mural);
+    
+    trava_travar(&g->trava_modulos);
+    int cabem = RESERVA_MODULOS - g->qtd_reserva_modulos;
+    if (faltam > cabem) {
+        faltam = cabem;
     }
-    return resolvidos;
+    memcpy(&g->reserva_modulos[g->qtd_reserva_modulos], lote, sizeof(Modulo) * faltam);
+    g->qtd_reserva_modulos += faltam;
+    trava_destravar(&g->trava_modulos);
+}
+
+// Conta quantos módulos foram resolvidos (inclusive os já devolvidos ao pool)
+// NOTA: Deve ser chamada com trava_modulos já travada
+int contar_modulos_resolvidos(const GameState *g) {
+    return g->modulos_por_estado[MOD_RESOLVIDO].qtd + g->modulos_reciclados;
 }
 
 // Verifica se há módulos pendentes
-// NOTA: Deve ser chamada com mutex_jogo já travado
+// NOTA: Deve ser chamada com trava_modulos já travada
 int tem_modulos_pendentes(const GameState *g) {
-    for (int i = 0; i < g->qtd_modulos; i++) {
-        if (g->modulos[i].estado == MOD_PENDENTE) {
-            return 1; // Há pelo menos um módulo pendente
+    return g->modulos_por_estado[MOD_PENDENTE].qtd > 0;
+}
+
+// Muda o estado do módulo, movendo-o para o fim da lista do novo estado
+// NOTA: Deve ser chamada com trava_modulos já travada
+void mudar_estado_modulo(GameState *g, HandleModulo handle, EstadoModulo estado) {
+    PoolModulos *pool = &g->modulos;
+    int slot = pool_modulos_slot(pool, handle);
+    if (slot < 0 || pool->estado[slot] == estado) {
+        return;
+    }
+    
+    // Telemetria: quanto tempo o módulo ficou pendente (inclui a fila de um tedax)
+    if (pool->estado[slot] == MOD_PENDENTE) {
+        long long pendente_ms = instante_partida_ms(g) - pool->pendente_desde_ms[slot];
+        histograma_registrar(&g->hist_pendente, pendente_ms * 1000000LL);
+    } else if (estado == MOD_PENDENTE) {
+        pool->pendente_desde_ms[slot] = (int)instante_partida_ms(g);
+    }
+    
+    pool_lista_remover(pool, &g->modulos_por_estado[pool->estado[slot]], handle);
+    pool->estado[slot] = (unsigned char)estado;
+    pool_lista_inserir(&g->modulos, &g->modulos_por_estado[estado], handle);
+    ordem_modulos_mudar_estado(&g->ordem_modulos, slot, estado);
+}
+
+// Muda o estado do tedax, somando o tempo passado no estado anterior
+// NOTA: Deve ser chamada com a trava do tedax já travada
+void mudar_estado_tedax(GameState *g, Tedax *tedax, EstadoTedax estado) {
+    if (tedax->estado == estado) {
+        return;
+    }
+    long long agora = instante_partida_ms(g);
+    long long duracao = agora - tedax->estado_desde_ms;
+    tedax->tempo_estado_ms[tedax->estado] += duracao;
+    if (tedax->estado == TEDAX_ESPERANDO) {
+        tedax->qtd_esperas++;
+        if (duracao > tedax->espera_max_ms) {
+            tedax->espera_max_ms = duracao;
         }
     }
-    return 0; // Não há módulos pendentes
+    tedax->estado = estado;
+    tedax->estado_desde_ms = agora;
+}
+
+// Instante atual da partida em milissegundos
+long long instante_partida_ms(const GameState *g) {
+    if (g->modo_threads) {
+        long long fim = g->fim_ns > 0 ? g->fim_ns : agora_ns();
+        return (fim - g->inicio_ns) / 1000000LL;
+    }
+    return g->sim_ticks * SIM_TICK_MURAL_MS;
+}
+
+// Segundos desde que o módulo do slot foi resolvido
+// O relógio da partida é o tempo já consumido (tempo total - tempo restante)
+// NOTA: Deve ser chamada com trava_modulos já travada
+int idade_modulo_resolvido(const GameState *g, int slot) {
+    int agora = g->tempo_total_partida - g->tempo_restante;
+    return agora - g->modulos.instante_resolvido[slot];
+}
+
+// Devolve ao pool os resolvidos que já passaram do tempo de exibição
+// A lista de resolvidos está em ordem de resolução: para no primeiro recente
+// Tedax que ainda guardem o handle de um deles vão encontrá-lo inválido
+// NOTA: Deve ser chamada com trava_modulos já travada
+void reciclar_modulos_resolvidos(GameState *g) {
+    ListaModulos *resolvidos = &g->modulos_por_estado[MOD_RESOLVIDO];
+    HandleModulo h = pool_lista_primeiro(&g->modulos, resolvidos);
+    while (h != MODULO_NENHUM) {
+        if (idade_modulo_resolvido(g, pool_modulos_slot(&g->modulos, h)) < TEMPO_EXIBICAO_RESOLVIDO) {
+            break;
+        }
+        HandleModulo proximo = pool_lista_proximo(&g->modulos, h);
+        indice_modulos_remover(&g->indice_modulos, pool_modulos_obter(&g->modulos, h)->id);
+        if (!ordem_modulos_remover(&g->ordem_modulos, pool_modulos_slot(&g->modulos, h))) {
+            g->resolvidos_ocultos--; // já tinha saído da lista da tela
+        }
+        pool_lista_remover(&g->modulos, resolvidos, h);
+        pool_modulos_liberar(&g->modulos, h);
+        g->modulos_reciclados++;
+        h = proximo;
+    }
+}
+
+// Tira da lista da tela os resolvidos antigos: 20s depois de resolvidos, ou
+// 10s se houver 8 ou mais resolvidos recentes (os vivos, já que o relógio
+// recicla os de 20s a cada segundo). A lista de resolvidos está em ordem de
+// resolução, então os ocultos são sempre os primeiros dela, até
+// ultimo_resolvido_oculto: a fronteira só anda sobre quem muda de lado (se o
+// limite volta para 20s, os de 10 a 20s reaparecem)
+// NOTA: Deve ser chamada com trava_modulos já travada
+void atualizar_resolvidos_ocultos(GameState *g) {
+    PoolModulos *pool = &g->modulos;
+    ListaModulos *resolvidos = &g->modulos_por_estado[MOD_RESOLVIDO];
+    int limite = resolvidos->qtd >= 8 ? 10 : TEMPO_EXIBICAO_RESOLVIDO;
+    
+    // Fronteira reciclada: todos os ocultos antes dela também voltaram ao pool
+    HandleModulo fronteira = g->ultimo_resolvido_oculto;
+    if (fronteira != MODULO_NENHUM && !pool_modulos_obter(pool, fronteira)) {
+        fronteira = MODULO_NENHUM;
+    }
+    
+    HandleModulo h = fronteira != MODULO_NENHUM ? pool_lista_proximo(pool, fronteira)
+                                                : pool_lista_primeiro(pool, resolvidos);
+    while (h != MODULO_NENHUM && idade_modulo_resolvido(g, pool_modulos_slot(pool, h)) >= limite) {
+        ordem_modulos_exibir(&g->ordem_modulos, pool_modulos_slot(pool, h), 0);
+        g->resolvidos_ocultos++;
+        fronteira = h;
+        h = pool_lista_proximo(pool, h);
+    }
+    while (fronteira != MODULO_NENHUM &&
+           idade_modulo_resolvido(g, pool_modulos_slot(pool, fronteira)) < limite) {
+        ordem_modulos_exibir(&g->ordem_modulos, pool_modulos_slot(pool, fronteira), 1);
+        g->resolvidos_ocultos--;
+        fronteira = pool_lista_anterior(pool, fronteira);
+    }
+    g->ultimo_resolvido_oculto = fronteira;
 }
 
 // Verifica se todos os módulos necessários foram resolvidos
-// NOTA: Deve ser chamada com mutex_jogo já travado
+// NOTA: Deve ser chamada com trava_modulos já travada
 int todos_modulos_resolvidos(const GameState *g) {
     int resolvidos = contar_modulos_resolvidos(g);
     // Vitória quando resolver pelo menos o número necessário de módulos
     return (resolvidos >= g->modulos_necessarios);
 }
 
+// Imprime as métricas da partida em saida
+void imprimir_estatisticas_partida(const GameState *g, FILE *saida) {
+    long long fim = g->fim_ns > 0 ? g->fim_ns : agora_ns();
+    double duracao_s = (fim - g->inicio_ns) / 1e9;
+    long despertares = atomic_load(&g->despertares);
+    
+    fprintf(saida, "=== Estatisticas da partida (%s, modo %s) ===\n",
+            nome_dificuldade(g->dificuldade), g->modo_reator ? "reator" : "threads");
+    fprintf(saida, "Duracao: %.1f s\n", duracao_s);
+    fprintf(saida, "Semente: %llu\n", (unsigned long long)g->semente);
+    fprintf(saida, "Despertares: %ld (%.2f/s)\n", despertares,
+            duracao_s > 0 ? despertares / duracao_s : 0.0);
+    histograma_imprimir(saida, "Handoff de bancada", &g->hist_handoff_bancada);
+    histograma_imprimir(saida, "Modulo pendente", &g->hist_pendente);
+    
+    // Caminho de um comando, do teclado até a tela
+    histograma_imprimir(saida, "Digitacao (1a tecla -> Enter)", &g->hist_digitacao);
+    histograma_imprimir(saida, "Enter -> comando aplicado", &g->hist_enter_aplicado);
+    histograma_imprimir(saida, "Enter -> tedax na bancada", &g->hist_enter_bancada);
+    histograma_imprimir(saida, "Tecla -> quadro", &g->hist_tecla_quadro);
+    histograma_imprimir(saida, "Enter -> quadro", &g->hist_enter_quadro);
+    
+    // Tela: só os painéis que mudaram são redesenhados (ver desenhar_tela)
+    if (g->quadros_contados > 0) {
+        fprintf(saida, "Tela: %ld quadros, %lld bytes (%.0f bytes/quadro, max %ld)\n",
+                g->quadros_desenhados, g->bytes_tela,
+                (double)g->bytes_tela / g->quadros_contados, g->bytes_quadro_max);
+    } else {
+        fprintf(saida, "Tela: %ld quadros (bytes nao contados)\n", g->quadros_desenhados);
+    }
+    fprintf(saida, "Retratos: %ld montados, %ld iguais ao anterior (descartados)\n",
+            g->tela.publicacoes, g->tela.publicacoes_iguais);
+    if (g->trabalhadores_tedax > 0) {
+        fprintf(saida, "Escalonador: %d tedax em %d trabalhadores, %ld tarefas (%ld roubadas)\n",
+                g->qtd_tedax, g->trabalhadores_tedax, g->tarefas_tedax, g->tarefas_roubadas);
+        histograma_imprimir(saida, "Atraso dos passos dos tedax", &g->hist_atraso_tedax);
+        fprintf(saida, "Passos de tedax estourados: %ld\n", g->passos_tedax_estourados);
+    }
+    
+    // Laços periódicos (só rodam no modo com threads)
+    if (!g->modo_reator) {
+        ritmo_imprimir(saida, "relogio", &g->ritmo_relogio);
+        ritmo_imprimir(saida, "mural", &g->ritmo_mural);
+    }
+    
+    // Espera e retenção das travas, por papel de quem travou (ver PapelTrava)
+    EstatTrava tedax[QTD_PAPEIS_TRAVA], bancadas[QTD_PAPEIS_TRAVA];
+    memset(tedax, 0, sizeof(tedax));
+    memset(bancadas, 0, sizeof(bancadas));
+    for (int i = 0; i < g->qtd_tedax; i++) {
+        trava_somar(tedax, &g->tedax[i].trava);
+    }
+    for (int i = 0; i < g->qtd_bancadas; i++) {
+        trava_somar(bancadas, &g->bancadas[i].trava);
+    }
+    trava_imprimir(saida, "modulos", g->trava_modulos.est);
+    trava_imprimir(saida, "tedax", tedax);
+    trava_imprimir(saida, "bancadas", bancadas);
+    trava_imprimir(saida, "ui", g->trava_ui.est);
+    trava_imprimir(saida, "publicacao", g->tela.trava_publicacao.est);
+    trava_imprimir(saida, "quadro", g->trava_quadro.est);
+}
+
 // Retorna o nome da cor como string
 const char* nome_cor(CorBotao cor) {
     switch (cor) {
@@ -225,742 +493,3 @@ const char* nome_dificuldade(Dificuldade dificuldade) {
             return "DESCONHECIDA";
     }
 }
-
-// ============================================================================
-// IMPLEMENTAÇÃO DAS THREADS
-// ============================================================================
-
-// Thread do Mural de Módulos Pendentes
-void* thread_mural(void* arg) {
-    GameState *g = (GameState*)arg;
-    struct timespec ts;
-    ts.tv_sec = 0;
-    ts.tv_nsec = 200000000L; // 0.2 segundos
-    
-    while (g->jogo_rodando && !g->jogo_terminou) {
-        pthread_mutex_lock(&g->mutex_jogo);
-        
-        if (g->qtd_modulos < g->max_modulos) {
-            g->ticks_desde_ultimo_modulo++;
-            
-            if (g->ticks_desde_ultimo_modulo >= g->intervalo_geracao) {
-                gerar_novo_modulo(g);
-                g->ticks_desde_ultimo_modulo = 0;
-            }
-        }
-        
-        // Se não há módulos pendentes e ainda não gerou o máximo, gerar imediatamente
-        if (!tem_modulos_pendentes(g) && g->qtd_modulos < g->max_modulos) {
-            gerar_novo_modulo(g);
-        }
-        
-        pthread_mutex_unlock(&g->mutex_jogo);
-        
-        nanosleep(&ts, NULL);
-    }
-    
-    return NULL;
-}
-
-// Thread de Exibição de Informações
-void* thread_exibicao(void* arg) {
-    GameState *g = (GameState*)arg;
-    struct timespec ts;
-    ts.tv_sec = 0;
-    ts.tv_nsec = 200000000L; // 0.2 segundos
-    
-    // Buffer de instrução compartilhado (gerenciado pela thread coordenador)
-    extern char buffer_instrucao_global[64];
-    
-    // Inicializar ncurses nesta thread
-    inicializar_ncurses();
-    
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_CYAN, COLOR_BLACK);
-        init_pair(2, COLOR_GREEN, COLOR_BLACK);
-        init_pair(3, COLOR_YELLOW, COLOR_BLACK);
-    }
-    
-    while (g->jogo_rodando && !g->jogo_terminou) {
-        pthread_mutex_lock(&g->mutex_jogo);
-        
-        // Desenhar tela
-        desenhar_tela(g, buffer_instrucao_global);
-        
-        pthread_mutex_unlock(&g->mutex_jogo);
-        
-        nanosleep(&ts, NULL);
-    }
-    
-    
-    return NULL;
-}
-
-// Thread de um Tedax
-void* thread_tedax(void* arg) {
-    typedef struct {
-        GameState *g;
-        int tedax_id;
-    } TedaxArgs;
-    
-    TedaxArgs *args = (TedaxArgs*)arg;
-    GameState *g = args->g;
-    int tedax_id = args->tedax_id;
-    Tedax *tedax = &g->tedax[tedax_id];
-    
-    struct timespec ts;
-    ts.tv_sec = 1;  // 1 segundo
-    ts.tv_nsec = 0;
-    
-    while (g->jogo_rodando && !g->jogo_terminou) {
-        pthread_mutex_lock(&g->mutex_jogo);
-        
-        // Incrementar tempo desde resolvido para todos os módulos resolvidos
-        for (int i = 0; i < g->qtd_modulos; i++) {
-            if (g->modulos[i].estado == MOD_RESOLVIDO && g->modulos[i].tempo_desde_resolvido >= 0) {
-                g->modulos[i].tempo_desde_resolvido++;
-            }
-        }
-        
-        // Verificar se este tedax está em espera e a bancada ficou livre
-        if (tedax->estado == TEDAX_ESPERANDO && tedax->bancada_atual >= 0) {
-            int bancada_idx = tedax->bancada_atual;
-            // Verificar se a bancada está livre e este tedax é o que está registrado como esperando
-            if (g->bancadas[bancada_idx].estado == BANCADA_LIVRE && 
-                g->bancadas[bancada_idx].tedax_esperando == tedax->id) {
-                // Bancada ficou livre e este tedax é o primeiro da fila: ocupar
-                g->bancadas[bancada_idx].estado = BANCADA_OCUPADA;
-                g->bancadas[bancada_idx].tedax_ocupando = tedax->id;
-                g->bancadas[bancada_idx].tedax_esperando = -1;
-                tedax->estado = TEDAX_OCUPADO;
-                
-                // Garantir que o módulo está em EM_EXECUCAO e com tempo correto
-                if (tedax->modulo_atual >= 0) {
-                    Modulo *mod_esperando = &g->modulos[tedax->modulo_atual];
-                    if (mod_esperando->estado != MOD_EM_EXECUCAO) {
-                        mod_esperando->estado = MOD_EM_EXECUCAO;
-                    }
-                    if (mod_esperando->tempo_restante <= 0) {
-                        mod_esperando->tempo_restante = mod_esperando->tempo_total;
-                    }
-                }
-            } else if (g->bancadas[bancada_idx].estado == BANCADA_OCUPADA && 
-                       g->bancadas[bancada_idx].tedax_ocupando != tedax->id &&
-                       g->bancadas[bancada_idx].tedax_esperando != tedax->id) {
-                // Outro tedax ocupou a bancada e este não está mais na fila: procurar outra bancada
-                int bancada_encontrada = 0;
-                for (int i = 0; i < g->qtd_bancadas; i++) {
-                    if (g->bancadas[i].estado == BANCADA_LIVRE) {
-                        // Limpar registro anterior
-                        if (bancada_idx >= 0 && bancada_idx < g->qtd_bancadas) {
-                            if (g->bancadas[bancada_idx].tedax_esperando == tedax->id) {
-                                g->bancadas[bancada_idx].tedax_esperando = -1;
-                            }
-                        }
-                        // Ocupar nova bancada
-                        tedax->bancada_atual = i;
-                        g->bancadas[i].estado = BANCADA_OCUPADA;
-                        g->bancadas[i].tedax_ocupando = tedax->id;
-                        g->bancadas[i].tedax_esperando = -1;
-                        tedax->estado = TEDAX_OCUPADO;
-                        bancada_encontrada = 1;
-                        
-                        // Garantir que o módulo está em EM_EXECUCAO
-                        if (tedax->modulo_atual >= 0) {
-                            Modulo *mod_esperando = &g->modulos[tedax->modulo_atual];
-                            if (mod_esperando->estado != MOD_EM_EXECUCAO) {
-                                mod_esperando->estado = MOD_EM_EXECUCAO;
-                            }
-                            if (mod_esperando->tempo_restante <= 0) {
-                                mod_esperando->tempo_restante = mod_esperando->tempo_total;
-                            }
-                        }
-                        break;
-                    }
-                }
-                
-                if (!bancada_encontrada) {
-                    // Nenhuma bancada livre: manter em espera na primeira disponível
-                    int nova_bancada_idx = 0;
-                    if (bancada_idx != nova_bancada_idx) {
-                        // Limpar registro anterior
-                        if (bancada_idx >= 0 && bancada_idx < g->qtd_bancadas) {
-                            if (g->bancadas[bancada_idx].tedax_esperando == tedax->id) {
-                                g->bancadas[bancada_idx].tedax_esperando = -1;
-                            }
-                        }
-                        // Registrar na nova bancada apenas se não houver outro esperando
-                        if (g->bancadas[nova_bancada_idx].tedax_esperando < 0) {
-                            tedax->bancada_atual = nova_bancada_idx;
-                            g->bancadas[nova_bancada_idx].tedax_esperando = tedax->id;
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Verificar se este tedax acabou de sair da espera e precisa começar a processar
-        // Isso garante que módulos atribuídos durante espera sejam processados imediatamente
-        if (tedax->estado == TEDAX_OCUPADO && tedax->modulo_atual >= 0) {
-            Modulo *mod = &g->modulos[tedax->modulo_atual];
-            
-            // Verificação de segurança: não processar módulos já resolvidos
-            if (mod->estado == MOD_RESOLVIDO) {
-                // Módulo já foi resolvido - liberar tedax e bancada
-                if (tedax->bancada_atual >= 0) {
-                    g->bancadas[tedax->bancada_atual].estado = BANCADA_LIVRE;
-                    g->bancadas[tedax->bancada_atual].tedax_ocupando = -1;
-                }
-                tedax->estado = TEDAX_LIVRE;
-                tedax->modulo_atual = -1;
-                tedax->bancada_atual = -1;
-                pthread_mutex_unlock(&g->mutex_jogo);
-                nanosleep(&ts, NULL);
-                continue;
-            }
-            
-            // Verificar se o módulo está realmente em execução
-            // Se não estiver, significa que acabou de ser atribuído e precisa ser iniciado
-            if (mod->estado != MOD_EM_EXECUCAO) {
-                // Módulo não está em execução ainda - isso não deveria acontecer
-                // Mas vamos garantir que esteja correto
-                mod->estado = MOD_EM_EXECUCAO;
-                if (mod->tempo_restante <= 0) {
-                    mod->tempo_restante = mod->tempo_total;
-                }
-            }
-            
-            // Verificar se o módulo tem instrução digitada (pode ter sido atribuído em espera)
-            // Se não tiver, não processar ainda
-            if (strlen(mod->instrucao_digitada) == 0) {
-                // Módulo ainda não tem instrução - não processar
-                pthread_mutex_unlock(&g->mutex_jogo);
-                nanosleep(&ts, NULL);
-                continue;
-            }
-            
-            // Decrementar tempo restante
-            mod->tempo_restante--;
-            
-            // Quando o tempo acabar, verificar se a instrução estava correta
-            if (mod->tempo_restante <= 0) {
-            // Comparar instrução digitada com a correta usando validação específica do tipo
-            if (validar_instrucao_modulo(mod, mod->instrucao_digitada)) {
-                // Instrução correta: módulo resolvido
-                mod->estado = MOD_RESOLVIDO;
-                mod->tempo_desde_resolvido = 0; // Iniciar contador de tempo desde resolvido
-            } else {
-                // Instrução incorreta: módulo volta para o mural
-                mod->estado = MOD_PENDENTE;
-                mod->tempo_restante = mod->tempo_total; // Resetar tempo
-                mod->instrucao_digitada[0] = '\0';      // Limpar instrução
-                mod->tempo_desde_resolvido = -1;         // Resetar contador
-                g->erros_cometidos++; // Incrementar contador de erros
-            }
-                
-                    // Liberar bancada
-                if (tedax->bancada_atual >= 0) {
-                    int bancada_idx = tedax->bancada_atual;
-                    g->bancadas[bancada_idx].estado = BANCADA_LIVRE;
-                    g->bancadas[bancada_idx].tedax_ocupando = -1;
-                    
-                    // Verificar se há tedax esperando por esta bancada
-                    // IMPORTANTE: Verificar se a bancada ainda está livre antes de atribuir
-                    if (g->bancadas[bancada_idx].estado == BANCADA_LIVRE && 
-                        g->bancadas[bancada_idx].tedax_esperando >= 0) {
-                        int tedax_esperando_id = g->bancadas[bancada_idx].tedax_esperando;
-                        // Procurar o tedax pelo ID
-                        for (int i = 0; i < g->qtd_tedax; i++) {
-                            if (g->tedax[i].id == tedax_esperando_id && 
-                                g->tedax[i].estado == TEDAX_ESPERANDO &&
-                                g->tedax[i].bancada_atual == bancada_idx) {
-                                // Verificar novamente se a bancada ainda está livre (evitar condição de corrida)
-                                if (g->bancadas[bancada_idx].estado == BANCADA_LIVRE) {
-                                    // Ocupar bancada com o tedax que estava esperando
-                                    g->bancadas[bancada_idx].estado = BANCADA_OCUPADA;
-                                    g->bancadas[bancada_idx].tedax_ocupando = g->tedax[i].id;
-                                    g->bancadas[bancada_idx].tedax_esperando = -1;
-                                    g->tedax[i].estado = TEDAX_OCUPADO;
-                                    
-                                    // Garantir que o módulo está em EM_EXECUCAO e com tempo correto
-                                    if (g->tedax[i].modulo_atual >= 0) {
-                                        Modulo *mod_esperando = &g->modulos[g->tedax[i].modulo_atual];
-                                        if (mod_esperando->estado != MOD_EM_EXECUCAO) {
-                                            mod_esperando->estado = MOD_EM_EXECUCAO;
-                                        }
-                                        // Se o tempo foi zerado ou está inválido, resetar
-                                        if (mod_esperando->tempo_restante <= 0) {
-                                            mod_esperando->tempo_restante = mod_esperando->tempo_total;
-                                        }
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                    }
-                    
-                    pthread_cond_broadcast(&g->cond_bancada_disponivel);
-                }
-                
-                // Verificar se há módulos na fila deste tedax (máximo 1)
-                if (tedax->qtd_fila > 0) {
-                    // Pegar o módulo da fila (só há 1)
-                    int proximo_modulo_idx = tedax->fila_modulos[0];
-                    
-                    // Verificar se o módulo é válido
-                    if (proximo_modulo_idx >= 0 && proximo_modulo_idx < g->qtd_modulos) {
-                        // Atribuir o próximo módulo ao tedax
-                        Modulo *prox_mod = &g->modulos[proximo_modulo_idx];
-                        
-                        // Verificação de segurança: não processar módulos já resolvidos
-                        if (prox_mod->estado == MOD_RESOLVIDO) {
-                            // Módulo já foi resolvido - limpar fila
-                            tedax->fila_modulos[0] = -1;
-                            tedax->qtd_fila = 0;
-                        } else {
-                            // Remover o módulo da fila
-                            tedax->fila_modulos[0] = -1;
-                            tedax->qtd_fila = 0;
-                            
-                            // Verificar se a bancada ainda está disponível
-                            if (tedax->bancada_atual >= 0 && 
-                                g->bancadas[tedax->bancada_atual].estado == BANCADA_LIVRE) {
-                                // Bancada ainda livre: continuar usando
-                                tedax->modulo_atual = proximo_modulo_idx;
-                                prox_mod->estado = MOD_EM_EXECUCAO;
-                                prox_mod->tempo_restante = prox_mod->tempo_total;
-                                g->bancadas[tedax->bancada_atual].estado = BANCADA_OCUPADA;
-                                g->bancadas[tedax->bancada_atual].tedax_ocupando = tedax->id;
-                            } else {
-                                // Bancada não está mais disponível: procurar outra ou entrar em espera
-                                int bancada_encontrada = 0;
-                                for (int i = 0; i < g->qtd_bancadas; i++) {
-                                    if (g->bancadas[i].estado == BANCADA_LIVRE) {
-                                        tedax->modulo_atual = proximo_modulo_idx;
-                                        tedax->bancada_atual = i;
-                                        prox_mod->estado = MOD_EM_EXECUCAO;
-                                        prox_mod->tempo_restante = prox_mod->tempo_total;
-                                        g->bancadas[i].estado = BANCADA_OCUPADA;
-                                        g->bancadas[i].tedax_ocupando = tedax->id;
-                                        bancada_encontrada = 1;
-                                        break;
-                                    }
-                                }
-                                
-                                if (!bancada_encontrada) {
-                                    // Nenhuma bancada livre: entrar em espera na primeira disponível
-                                    if (g->qtd_bancadas > 0) {
-                                        int bancada_idx = 0;
-                                        tedax->modulo_atual = proximo_modulo_idx;
-                                        tedax->bancada_atual = bancada_idx;
-                                        tedax->estado = TEDAX_ESPERANDO;
-                                        prox_mod->estado = MOD_EM_EXECUCAO;
-                                        prox_mod->tempo_restante = prox_mod->tempo_total;
-                                        g->bancadas[bancada_idx].tedax_esperando = tedax->id;
-                                    } else {
-                                        // Sem bancadas: voltar módulo para pendente
-                                        prox_mod->estado = MOD_PENDENTE;
-                                        tedax->modulo_atual = -1;
-                                        tedax->bancada_atual = -1;
-                                        tedax->estado = TEDAX_LIVRE;
-                                    }
-                                }
-                            }
-                        }
-                    } else {
-                        // Módulo inválido - limpar fila
-                        tedax->fila_modulos[0] = -1;
-                        tedax->qtd_fila = 0;
-                    }
-                } else {
-                    // Não há módulos na fila: liberar tedax
-                    tedax->estado = TEDAX_LIVRE;
-                    tedax->modulo_atual = -1;
-                    tedax->bancada_atual = -1;
-                }
-                
-                // Se não há módulos pendentes e ainda não gerou o máximo, gerar um novo imediatamente
-                if (!tem_modulos_pendentes(g) && g->qtd_modulos < g->max_modulos) {
-                    gerar_novo_modulo(g);
-                }
-                
-                // Sinalizar que há módulo disponível novamente
-                pthread_cond_broadcast(&g->cond_modulo_disponivel);
-            }
-        }
-        
-        pthread_mutex_unlock(&g->mutex_jogo);
-        
-        nanosleep(&ts, NULL);
-    }
-    
-    free(args);
-    return NULL;
-}
-
-// Função auxiliar para processar comando do formato T1B1M1:ppp
-// Retorna 1 se sucesso, 0 se falha
-int processar_comando(const char* buffer, GameState *g, 
-                      int *tedax_idx, int *bancada_idx, int *modulo_idx, 
-                      char *instrucao) {
-    // Inicializar valores como -1 (não especificado)
-    *tedax_idx = -1;
-    *bancada_idx = -1;
-    *modulo_idx = -1;
-    instrucao[0] = '\0';
-    
-    // Procurar por ':' que separa o comando da instrução
-    const char *separador = strchr(buffer, ':');
-    
-    if (!separador) {
-        // Se não há ':', tratar tudo como instrução (caso: apenas "ppp")
-        // Verificar se há algum T, B ou M no buffer - se houver, é formato inválido
-        int tem_comando = 0;
-        for (int i = 0; buffer[i] != '\0'; i++) {
-            if (buffer[i] == 'T' || buffer[i] == 't' || 
-                buffer[i] == 'B' || buffer[i] == 'b' || 
-                buffer[i] == 'M' || buffer[i] == 'm') {
-                tem_comando = 1;
-                break;
-            }
-        }
-        
-        if (tem_comando) {
-            return 0; // Formato inválido - tem T/B/M mas falta ':'
-        }
-        
-        // Apenas instrução, sem especificações
-        strncpy(instrucao, buffer, 15);
-        instrucao[15] = '\0';
-        return 1;
-    }
-    
-    // Copiar instrução (parte após ':')
-    strncpy(instrucao, separador + 1, 15);
-    instrucao[15] = '\0';
-    
-    // Se a parte antes do ':' está vazia (caso: ":ppp"), apenas instrução
-    int len_comando = separador - buffer;
-    if (len_comando == 0) {
-        return 1; // Apenas instrução, sem especificações
-    }
-    
-    // Processar parte antes do ':' (T1B1M1)
-    char comando[32];
-    strncpy(comando, buffer, len_comando);
-    comando[len_comando] = '\0';
-    
-    // Fazer parsing do comando
-    int i = 0;
-    while (i < len_comando) {
-        if (comando[i] == 'T' || comando[i] == 't') {
-            // Ler número do tedax
-            i++;
-            int num = 0;
-            while (i < len_comando && comando[i] >= '0' && comando[i] <= '9') {
-                num = num * 10 + (comando[i] - '0');
-                i++;
-            }
-            if (num >= 1 && num <= g->qtd_tedax) {
-                *tedax_idx = num - 1; // Converter para índice (0-based)
-            } else {
-                return 0; // Tedax inválido
-            }
-        } else if (comando[i] == 'B' || comando[i] == 'b') {
-            // Ler número da bancada
-            i++;
-            int num = 0;
-            while (i < len_comando && comando[i] >= '0' && comando[i] <= '9') {
-                num = num * 10 + (comando[i] - '0');
-                i++;
-            }
-            if (num >= 1 && num <= g->qtd_bancadas) {
-                *bancada_idx = num - 1; // Converter para índice (0-based)
-            } else {
-                return 0; // Bancada inválida
-            }
-        } else if (comando[i] == 'M' || comando[i] == 'm') {
-            // Ler número do módulo (ID do módulo, não índice)
-            i++;
-            int num = 0;
-            while (i < len_comando && comando[i] >= '0' && comando[i] <= '9') {
-                num = num * 10 + (comando[i] - '0');
-                i++;
-            }
-            // Procurar módulo pelo ID
-            int encontrado = 0;
-            for (int j = 0; j < g->qtd_modulos; j++) {
-                if (g->modulos[j].id == num) {
-                    *modulo_idx = j;
-                    encontrado = 1;
-                    break;
-                }
-            }
-            if (!encontrado) {
-                return 0; // Módulo não encontrado
-            }
-        } else {
-            i++; // Ignorar caracteres desconhecidos
-        }
-    }
-    
-    return 1; // Sucesso
-}
-
-// Thread do Coordenador (Jogador)
-void* thread_coordenador(void* arg) {
-    GameState *g = (GameState*)arg;
-    extern char buffer_instrucao_global[64];
-    int buffer_len = 0;
-    
-    while (g->jogo_rodando && !g->jogo_terminou) {
-        int ch = getch();
-        
-        if (ch == ERR) {
-            // Nenhuma tecla pressionada
-        } else if (ch == 'q' || ch == 'Q') {
-            pthread_mutex_lock(&g->mutex_jogo);
-            g->jogo_rodando = 0;
-            pthread_mutex_unlock(&g->mutex_jogo);
-            break;
-        } else {
-            pthread_mutex_lock(&g->mutex_jogo);
-            
-            // Processar BACKSPACE
-            if (ch == KEY_BACKSPACE || ch == 127 || ch == '\b') {
-                if (buffer_len > 0) {
-                    buffer_len--;
-                    buffer_instrucao_global[buffer_len] = '\0';
-                }
-            }
-            // Processar ENTER para enviar comando
-            else if (ch == '\n' || ch == '\r') {
-                // Limpar mensagem de erro anterior
-                g->mensagem_erro[0] = '\0';
-                
-                int tedax_idx = -1, bancada_idx = -1, modulo_idx = -1;
-                char instrucao[16] = "";
-                
-                // Processar comando no formato T1B1M1:ppp
-                if (processar_comando(buffer_instrucao_global, g, &tedax_idx, &bancada_idx, &modulo_idx, instrucao)) {
-                    // Aplicar regras de default para valores não especificados
-                    
-                    // Se tedax não especificado, pegar APENAS o tedax LIVRE com índice mais baixo
-                    // Não pegar tedax em espera para evitar sobrescrever módulos pendentes
-                    if (tedax_idx == -1) {
-                        for (int i = 0; i < g->qtd_tedax; i++) {
-                            if (g->tedax[i].estado == TEDAX_LIVRE) {
-                                tedax_idx = i;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    // Se bancada não especificada, pegar a bancada livre com índice mais baixo
-                    // Se não houver livre, pegar a primeira disponível (mesmo que ocupada, para espera)
-                    if (bancada_idx == -1) {
-                        for (int i = 0; i < g->qtd_bancadas; i++) {
-                            if (g->bancadas[i].estado == BANCADA_LIVRE) {
-                                bancada_idx = i;
-                                break;
-                            }
-                        }
-                        // Se não encontrou livre, pegar a primeira (permitir espera)
-                        if (bancada_idx == -1 && g->qtd_bancadas > 0) {
-                            bancada_idx = 0;
-                        }
-                    }
-                    
-                    // Se módulo não especificado, pegar o primeiro módulo pendente
-                    if (modulo_idx == -1) {
-                        for (int i = 0; i < g->qtd_modulos; i++) {
-                            if (g->modulos[i].estado == MOD_PENDENTE) {
-                                modulo_idx = i;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    // Validar recursos
-                    int valido = 1;
-                    
-                    if (tedax_idx < 0 || tedax_idx >= g->qtd_tedax) {
-                        valido = 0;
-                    }
-                    // Permitir atribuir módulos a tedax ocupados (será adicionado à fila)
-                    // Tedax em espera também pode receber módulos (substitui o anterior)
-                    
-                    if (bancada_idx < 0 || bancada_idx >= g->qtd_bancadas) {
-                        valido = 0;
-                    }
-                    // Não rejeitar bancadas ocupadas - permitir espera
-                    
-                    if (modulo_idx < 0 || modulo_idx >= g->qtd_modulos) {
-                        valido = 0;
-                    } else if (g->modulos[modulo_idx].estado != MOD_PENDENTE) {
-                        valido = 0; // Módulo especificado não está pendente
-                        // Verificação adicional: não permitir módulos já resolvidos
-                        if (g->modulos[modulo_idx].estado == MOD_RESOLVIDO) {
-                            valido = 0; // Módulo já foi resolvido
-                        }
-                    }
-                    
-                    if (valido && strlen(instrucao) > 0) {
-                        // Designar módulo para o tedax
-                        Modulo *mod = &g->modulos[modulo_idx];
-                        Tedax *t = &g->tedax[tedax_idx];
-                        
-                        // Copiar instrução
-                        strncpy(mod->instrucao_digitada, instrucao, 15);
-                        mod->instrucao_digitada[15] = '\0';
-                        
-                        // Verificar se o tedax está ocupado
-                        if (t->estado == TEDAX_OCUPADO) {
-                            // Tedax ocupado: adicionar módulo à fila
-                            
-                            // Verificar se já há um módulo na fila (máximo 1)
-                            if (t->qtd_fila > 0) {
-                                // Já há um módulo na fila - erro
-                                strncpy(g->mensagem_erro, "Tedax ja tem modulo em espera", 63);
-                                g->mensagem_erro[63] = '\0';
-                            } else {
-                                // Adicionar à fila
-                                t->fila_modulos[0] = modulo_idx;
-                                t->qtd_fila = 1;
-                                // Módulo permanece PENDENTE até ser processado pelo tedax
-                                // Não mudar para MOD_EM_EXECUCAO ainda - isso só acontece quando o tedax começar a processá-lo
-                                mod->estado = MOD_PENDENTE;
-                                mod->tempo_restante = mod->tempo_total;
-                            }
-                        } else {
-                            // Tedax livre ou em espera: atribuir normalmente
-                            
-                            // Se tedax estava esperando, limpar espera anterior e módulo anterior
-                            if (t->estado == TEDAX_ESPERANDO && t->bancada_atual >= 0) {
-                                // Remover da fila de espera da bancada anterior
-                                if (g->bancadas[t->bancada_atual].tedax_esperando == t->id) {
-                                    g->bancadas[t->bancada_atual].tedax_esperando = -1;
-                                }
-                                
-                                // Voltar o módulo anterior para PENDENTE se existir
-                                if (t->modulo_atual >= 0 && t->modulo_atual < g->qtd_modulos) {
-                                    Modulo *mod_anterior = &g->modulos[t->modulo_atual];
-                                    if (mod_anterior->estado == MOD_EM_EXECUCAO) {
-                                        mod_anterior->estado = MOD_PENDENTE;
-                                        mod_anterior->tempo_restante = mod_anterior->tempo_total;
-                                        mod_anterior->instrucao_digitada[0] = '\0';
-                                        mod_anterior->tempo_desde_resolvido = -1;
-                                    }
-                                }
-                            }
-                            
-                            // Mudar estado do módulo
-                            mod->estado = MOD_EM_EXECUCAO;
-                            mod->tempo_restante = mod->tempo_total;
-                            
-                            // Verificar se a bancada está livre
-                            if (g->bancadas[bancada_idx].estado == BANCADA_LIVRE) {
-                                // Bancada livre: ocupar imediatamente
-                                t->estado = TEDAX_OCUPADO;
-                                t->modulo_atual = modulo_idx;
-                                t->bancada_atual = bancada_idx;
-                                
-                                g->bancadas[bancada_idx].estado = BANCADA_OCUPADA;
-                                g->bancadas[bancada_idx].tedax_ocupando = t->id;
-                                g->bancadas[bancada_idx].tedax_esperando = -1;
-                            } else {
-                                // Bancada ocupada: tedax entra em espera
-                                // Verificar se já há outro tedax esperando por esta bancada
-                                if (g->bancadas[bancada_idx].tedax_esperando >= 0) {
-                                    // Já há outro tedax esperando: procurar outra bancada livre
-                                    int bancada_encontrada = 0;
-                                    for (int i = 0; i < g->qtd_bancadas; i++) {
-                                        if (g->bancadas[i].estado == BANCADA_LIVRE && 
-                                            g->bancadas[i].tedax_esperando < 0) {
-                                            // Bancada livre e sem ninguém esperando: ocupar
-                                            t->estado = TEDAX_OCUPADO;
-                                            t->modulo_atual = modulo_idx;
-                                            t->bancada_atual = i;
-                                            g->bancadas[i].estado = BANCADA_OCUPADA;
-                                            g->bancadas[i].tedax_ocupando = t->id;
-                                            g->bancadas[i].tedax_esperando = -1;
-                                            bancada_encontrada = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!bancada_encontrada) {
-                                        // Nenhuma bancada livre: entrar em espera na primeira disponível sem fila
-                                        int bancada_espera = -1;
-                                        for (int i = 0; i < g->qtd_bancadas; i++) {
-                                            if (g->bancadas[i].tedax_esperando < 0) {
-                                                bancada_espera = i;
-                                                break;
-                                            }
-                                        }
-                                        
-                                        if (bancada_espera >= 0) {
-                                            t->estado = TEDAX_ESPERANDO;
-                                            t->modulo_atual = modulo_idx;
-                                            t->bancada_atual = bancada_espera;
-                                            g->bancadas[bancada_espera].tedax_esperando = t->id;
-                                        } else {
-                                            // Todas as bancadas têm alguém esperando: usar a primeira mesmo assim
-                                            t->estado = TEDAX_ESPERANDO;
-                                            t->modulo_atual = modulo_idx;
-                                            t->bancada_atual = bancada_idx;
-                                            // Não sobrescrever o tedax_esperando existente para evitar perda
-                                        }
-                                    }
-                                } else {
-                                    // Nenhum tedax esperando: registrar este tedax
-                                    t->estado = TEDAX_ESPERANDO;
-                                    t->modulo_atual = modulo_idx;
-                                    t->bancada_atual = bancada_idx;
-                                    g->bancadas[bancada_idx].tedax_esperando = t->id;
-                                }
-                            }
-                        }
-                        
-                        // Limpar buffer
-                        buffer_len = 0;
-                        buffer_instrucao_global[0] = '\0';
-                    } else {
-                        // Recursos não disponíveis ou inválidos
-                        strncpy(g->mensagem_erro, "Entrada Invalida", 63);
-                        g->mensagem_erro[63] = '\0';
-                        buffer_len = 0;
-                        buffer_instrucao_global[0] = '\0';
-                    }
-                }
-                // Se o parsing falhou, mostrar erro e limpar buffer
-                else {
-                    strncpy(g->mensagem_erro, "Entrada Invalida", 63);
-                    g->mensagem_erro[63] = '\0';
-                    buffer_len = 0;
-                    buffer_instrucao_global[0] = '\0';
-                }
-            }
-            // Aceitar qualquer caractere imprimível
-            else if (ch >= 32 && ch <= 126) {
-                if (buffer_len < 63) { // Aumentar limite para suportar comandos maiores
-                    buffer_instrucao_global[buffer_len] = (char)ch;
-                    buffer_len++;
-                    buffer_instrucao_global[buffer_len] = '\0';
-                }
-            }
-            
-            pthread_mutex_unlock(&g->mutex_jogo);
-        }
-        
-        // Pequeno delay para não sobrecarregar
-        struct timespec ts;
-        ts.tv_sec = 0;
-        ts.tv_nsec = 50000000L; // 50ms
-        nanosleep(&ts, NULL);
-    }
-    
-    return NULL;
-}
-
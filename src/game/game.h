@@ -3,6 +3,14 @@
 
 #include <pthread.h>
 #include <semaphore.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "../estatisticas/estatisticas.h"
+#include "trava.h"
+#include "ritmo.h"
+#include "aleatorio.h"
+#include "comandos.h"
 
 // Estados possíveis de um módulo
 typedef enum {
@@ -64,14 +72,15 @@ typedef struct {
 typedef struct {
     char hash[32];              // hash exibido (ex: "SAESI")
     char senha_correta[16];     // senha numérica correta (ex: "54351")
-    char mapeamento[256];       // mapeamento de caracteres para números (para validação)
 } DadosSenha;
 
 // Dados específicos do módulo de fios
+#define FIOS_POR_MODULO 5
+#define FIOS_PADROES 5
 typedef struct {
-    char sequencia[32];         // sequência de cores (ex: "/R/G/B/Y/W/")
+    char sequencia[32];         // sequência de cores para exibição (ex: "/R/G/B/Y/W/")
     int padrao;                 // padrão de regra usado (0-4)
-    char instrucao_correta[16]; // instrução correta baseada no padrão
+    uint16_t cores;             // CorFio de cada fio em 3 bits (fio i nos bits 3*i..3*i+2)
 } DadosFios;
 
 // Union para dados específicos de cada tipo de módulo
@@ -81,56 +90,312 @@ typedef union {
     DadosFios fios;
 } DadosModulo;
 
-// Estrutura que representa um módulo da bomba
+// Estrutura que representa um módulo da bomba: só os dados frios (enigma e
+// textos). Estado e cronômetros ficam nos campos quentes do pool (PoolModulos),
+// indexados pelo slot do módulo
 typedef struct {
     int id;
-    TipoModulo tipo;            // tipo do módulo
-    int tempo_total;            // tempo necessário para desarmar (em segundos)
-    int tempo_restante;         // tempo restante quando estiver em execução
-    EstadoModulo estado;
+    TipoModulo tipo;            // tipo do módulo (lido junto com os dados do enigma;
+                                // contagens e filtros usam PoolModulos.tipo)
     
     DadosModulo dados;          // dados específicos do tipo de módulo
     char instrucao_correta[32]; // instrução correta (pode variar por tipo)
     char instrucao_digitada[32]; // o que o jogador enviou para este módulo
-    
-    int tempo_desde_resolvido;
 } Modulo;
 
+// ============================================================================
+// POOL DE MÓDULOS
+// ============================================================================
+// Módulos vivem em slabs de POOL_MODULOS_POR_SLAB alocados sob demanda. Um
+// resolvido que já saiu da tela volta para a lista livre e seu slot é
+// reaproveitado: a memória acompanha os módulos vivos, não quantos a partida
+// gerou. Referências guardam um HandleModulo (geração | slot); quando o slot é
+// reaproveitado a geração muda e o handle antigo deixa de ser aceito.
+
+#define POOL_MODULOS_POR_SLAB 64
+// Limite de slabs; pode ser trocado na compilação (make CFLAGS+=-DPOOL_MAX_SLABS=N)
+// Os vetores quentes abaixo têm POOL_MAX_MODULOS posições mesmo com o pool
+// vazio (cerca de 45 bytes por slot); os slabs só são alocados quando usados
+#ifndef POOL_MAX_SLABS
+#define POOL_MAX_SLABS 256
+#endif
+#define POOL_MAX_MODULOS (POOL_MODULOS_POR_SLAB * POOL_MAX_SLABS) // vivos ao mesmo tempo
+_Static_assert(POOL_MAX_MODULOS <= 65536, "o slot de um HandleModulo tem 16 bits");
+
+// Resolvidos ficam na tela por até este tempo e depois voltam para o pool
+#define TEMPO_EXIBICAO_RESOLVIDO 20
+
+typedef uint32_t HandleModulo;          // geração << 16 | slot
+#define MODULO_NENHUM ((HandleModulo)0) // nunca é válido (geração 0 não existe)
+
+typedef struct {
+    Modulo *slabs[POOL_MAX_SLABS];      // slabs alocados (os primeiros qtd_slabs)
+    int qtd_slabs;
+    uint16_t geracao[POOL_MAX_MODULOS]; // geração atual de cada slot
+    unsigned char em_uso[POOL_MAX_MODULOS];
+    int proximo[POOL_MAX_MODULOS];      // vivo: próximo na ordem de criação; livre: próximo livre
+    int anterior[POOL_MAX_MODULOS];     // vivo: anterior na ordem de criação
+    int lista_proximo[POOL_MAX_MODULOS];  // próximo na ListaModulos em que o slot está
+    int lista_anterior[POOL_MAX_MODULOS]; // anterior na ListaModulos em que o slot está
+    
+    // Campos quentes de cada slot (estrutura de arrays): os passos, as contagens
+    // e o filtro da tela leem só estes vetores, sem trazer o Modulo (frio,
+    // com os textos do enigma) para o cache
+    unsigned char estado[POOL_MAX_MODULOS];       // EstadoModulo
+    unsigned char tipo[POOL_MAX_MODULOS];         // TipoModulo (cópia de Modulo.tipo)
+    int tempo_total[POOL_MAX_MODULOS];            // tempo necessário para desarmar (em segundos)
+    int tempo_restante[POOL_MAX_MODULOS];         // tempo restante quando estiver em execução
+    int instante_resolvido[POOL_MAX_MODULOS];     // segundo da partida em que foi resolvido (-1 se não)
+    int pendente_desde_ms[POOL_MAX_MODULOS];      // instante (ms de partida) em que ficou pendente
+    
+    int livre;                          // topo da lista livre, ou -1
+    int primeiro;                       // módulo vivo mais antigo, ou -1
+    int ultimo;                         // módulo vivo mais novo, ou -1
+    int qtd_vivos;
+} PoolModulos;
+
+// Lista intrusiva de módulos do pool (os elos ficam em lista_proximo/lista_anterior)
+// Cada módulo está em no máximo uma ListaModulos por vez
+typedef struct {
+    int primeiro;               // slot do primeiro da lista, ou -1
+    int ultimo;                 // slot do último da lista, ou -1
+    int qtd;                    // quantidade de módulos na lista
+} ListaModulos;
+
+// Índice de ID do módulo -> handle, por endereçamento aberto (sondagem linear)
+// Capacidade ao menos o dobro do pool: a ocupação nunca passa de 50%
+#ifndef INDICE_MODULOS_BITS
+#define INDICE_MODULOS_BITS 15
+#endif
+#define INDICE_MODULOS_CAPACIDADE (1 << INDICE_MODULOS_BITS)
+_Static_assert(INDICE_MODULOS_CAPACIDADE >= 2 * POOL_MAX_MODULOS,
+               "INDICE_MODULOS_BITS pequeno demais para POOL_MAX_MODULOS");
+
+typedef struct {
+    int id;                     // ID do módulo, ou 0 se a entrada está vazia
+    HandleModulo handle;
+} EntradaIndiceModulo;
+
+typedef struct {
+    EntradaIndiceModulo entradas[INDICE_MODULOS_CAPACIDADE];
+    int qtd;
+} IndiceModulos;
+
+// Índice ordenado dos módulos que a lista da tela mostra, na ordem de criação,
+// com uma árvore de Fenwick por classe (TipoModulo x EstadoModulo): dá o total
+// de um filtro e o k-ésimo módulo dele em O(log n), sem percorrer a tabela
+// Cada módulo ocupa uma posição, dada na ordem de criação; as posições vagas
+// são descartadas quando o índice é refeito, então a memória acompanha os
+// módulos vivos (não os IDs já emitidos)
+#define ORDEM_CLASSES 9                 // 3 tipos x 3 estados
+#define ORDEM_VISIVEL 0x10              // bit de classe[posicao]: o módulo está nas árvores
+
+typedef struct {
+    int capacidade;             // posições 1..capacidade-1 (potência de 2; 0 antes do primeiro)
+    int proxima_posicao;        // posição do próximo módulo inserido
+    int ocupadas;               // posições com módulo (na lista ou fora dela)
+    int *arvore;                // capacidade x ORDEM_CLASSES contagens (Fenwick, por posição)
+    unsigned char *classe;      // por posição: 0 se vaga; senão 1 + tipo * 3 + estado,
+                                // com ORDEM_VISIVEL se está na lista
+    int *slot;                  // por posição: slot do módulo no pool
+    int *posicao;               // por slot do pool (POOL_MAX_MODULOS): posição, ou 0
+    int total[ORDEM_CLASSES];   // módulos na lista por classe
+} OrdemModulos;
+
 // Estrutura que representa um tedax
+// Estado, módulo, bancada e fila são protegidos pela trava do próprio tedax
 typedef struct {
     int id;
     EstadoTedax estado;
-    int modulo_atual;           // índice do módulo que está desarmando, ou -1 se livre
+    HandleModulo modulo_atual;  // módulo que está desarmando, ou MODULO_NENHUM se livre
     int bancada_atual;          // índice da bancada que está usando, ou -1 se livre
-    pthread_t thread_id;        // ID da thread deste tedax
     
     // Fila de módulos em espera para este tedax
-    int fila_modulos[1];        // índice do módulo em espera (máximo 1 módulo)
+    HandleModulo fila_modulos[1]; // módulo em espera (máximo 1 módulo)
     int qtd_fila;               // quantidade de módulos na fila (0 ou 1)
+    
+    // Enter dos comandos deste tedax, para medir até ele ocupar a bancada (0 se nenhum)
+    long long comando_enter_ns; // módulo atual, enquanto não ocupou a bancada
+    long long fila_enter_ns;    // módulo na fila
+    
+    // Telemetria: tempo em cada EstadoTedax (ms de partida, ver instante_partida_ms)
+    // Toda mudança de estado passa por mudar_estado_tedax
+    long long estado_desde_ms;  // instante em que entrou no estado atual
+    long long tempo_estado_ms[3]; // tempo já encerrado em cada estado
+    int qtd_esperas;            // vezes que saiu de TEDAX_ESPERANDO
+    long long espera_max_ms;    // maior espera contínua em TEDAX_ESPERANDO
+    
+    Trava trava;                // protege os campos acima (exceto id)
 } Tedax;
 
 // Estrutura que representa uma bancada
+// Uma bancada livre com tedax_esperando >= 0 fica reservada para esse tedax
+// Quem libera a bancada acorda o tedax em espera (ver simular_passo_tedax)
 typedef struct {
     int id;
     EstadoBancada estado;
     int tedax_ocupando;         // ID do tedax que está usando, ou -1 se livre
     int tedax_esperando;        // ID do tedax que está esperando por esta bancada, ou -1 se nenhum
+    
+    long long liberada_ns;      // instante em que ficou livre com tedax esperando, ou 0
+    
+    // Telemetria: tempo ocupada (ms de partida, ver instante_partida_ms)
+    long long ocupada_desde_ms; // instante em que foi ocupada (se ocupada)
+    long long tempo_ocupada_ms; // tempo já encerrado em BANCADA_OCUPADA
+    
+    Trava trava;                // protege os campos acima (exceto id)
 } Bancada;
 
+// Lista de módulos da tela: filtros e rolagem escolhidos pelo coordenador
+// (teclas em tratar_tecla_coordenador, protegida por trava_ui)
+typedef struct {
+    int filtro_tipo;            // TipoModulo mostrado, ou -1 para todos
+    int filtro_estado;          // EstadoModulo mostrado, ou -1 para todos
+    int primeira_linha;         // linha da lista filtrada no topo do painel
+    int ultima_primeira_linha;  // maior primeira_linha útil no último retrato
+} VisaoModulos;
+
+// Períodos dos laços do modo com threads (ver Ritmo em ritmo.h)
+#define PERIODO_RELOGIO_NS 1000000000LL     // relógio da partida
+#define PERIODO_MURAL_NS 200000000LL        // tick do mural (SIM_TICK_MURAL_MS)
+// O teclado não tem período: o coordenador dorme em poll() até chegar tecla,
+// nem a exibição: ela dorme em cond_tela_atualizada até haver retrato novo
+
+// Limite de quadros por segundo da exibição (--fps)
+#define FPS_MAXIMO_PADRAO 30
+#define FPS_MAXIMO_LIMITE 1000
+
+// Módulos pré-gerados guardados para o mural (ver repor_reserva_modulos)
+#define RESERVA_MODULOS 32
+
+// Fluxos de Aleatorio derivados da semente da partida
+#define FLUXO_MURAL 1
+#define FLUXO_MODULOS 2
+
+// Limites de tedax e bancadas numa partida personalizada (--tedax/--bancadas)
+#define MAX_TEDAX 4096
+#define MAX_BANCADAS 4096
+
+// ============================================================================
+// RETRATO DA TELA
+// ============================================================================
+// Cópia compacta e imutável do que a exibição desenha. Quem altera o estado
+// publica um retrato novo (publicar_retrato_tela); a exibição desenha o último
+// retrato publicado sem tocar em nenhuma trava do jogo. Um retrato igual ao
+// último publicado é descartado, então a tela só é redesenhada quando muda.
+
+#define RETRATO_MAX_MODULOS 100 // linhas copiadas, no máximo (ver linhas_modulos_tela)
+#define RETRATO_MAX_TEDAX 10    // tedax e bancadas além destes só entram na contagem
+#define RETRATO_MAX_BANCADAS 10
+
+// Linha de um tedax como aparece na tela
+typedef struct {
+    int id;
+    EstadoTedax estado;
+    int bancada_id;             // ID da bancada usada/esperada, ou 0
+    int modulo_id;              // ID do módulo atual, ou -1
+    int modulo_tempo_total;     // tempo do módulo atual (barra de progresso)
+    int modulo_tempo_restante;
+    int fila_modulo_id;         // ID do módulo na fila, ou -1
+} LinhaTedaxRetrato;
+
+// Linha de uma bancada como aparece na tela
+typedef struct {
+    int id;
+    EstadoBancada estado;
+    int tedax_ocupando;
+    int tedax_esperando;
+} LinhaBancadaRetrato;
+
+// Linha de um módulo visível na lista
+typedef struct {
+    int id;
+    EstadoModulo estado;
+    int tempo_total;
+    char info[64];              // texto de obter_info_exibicao_modulo
+} LinhaModuloRetrato;
+
+typedef struct {
+    Dificuldade dificuldade;
+    int tempo_restante;
+    int resolvidos;             // módulos resolvidos na partida
+    int modulos_necessarios;
+    
+    int qtd_tedax;              // tedax na partida
+    int qtd_linhas_tedax;       // tedax copiados (no máximo RETRATO_MAX_TEDAX)
+    LinhaTedaxRetrato tedax[RETRATO_MAX_TEDAX];
+    int qtd_bancadas;           // bancadas na partida
+    int qtd_linhas_bancadas;    // bancadas copiadas (no máximo RETRATO_MAX_BANCADAS)
+    LinhaBancadaRetrato bancadas[RETRATO_MAX_BANCADAS];
+    
+    int qtd_modulos;            // módulos criados na partida
+    int resolvidos_removidos;   // resolvidos antigos que não aparecem mais
+    int filtro_tipo;            // filtros da lista (VisaoModulos), -1 = todos
+    int filtro_estado;
+    int qtd_filtrados;          // módulos da lista que passam nos filtros
+    int primeira_linha;         // posição de linhas[0] entre os filtrados
+    int qtd_linhas;             // linhas copiadas a partir dela
+    LinhaModuloRetrato linhas[RETRATO_MAX_MODULOS];
+    
+    char buffer_instrucao[64];
+    char mensagem_erro[64];
+    
+    long long tecla_ns;         // última tecla refletida em buffer_instrucao, ou 0
+    long long enter_ns;         // Enter do último comando aplicado neste estado, ou 0
+} RetratoTela;
+
+// Bit de "pronto" que indica retrato publicado ainda não lido pela exibição
+#define RETRATO_NOVO 4
+
+// Buffer triplo de retratos: um sendo escrito, um pronto e um sendo desenhado
+// A troca entre eles é um atomic_exchange em "pronto", sem travas para a exibição
+typedef struct {
+    RetratoTela retratos[3];
+    atomic_int pronto;          // índice do último retrato publicado (| RETRATO_NOVO)
+    int escrita;                // índice de quem publica (protegido por trava_publicacao)
+    int leitura;                // índice em uso pela exibição (só ela mexe)
+    Trava trava_publicacao;     // serializa quem publica; a exibição nunca a usa
+    
+    // Protegidos por trava_publicacao
+    int publicado;              // índice do último retrato publicado, ou -1
+    long publicacoes;           // retratos montados
+    long publicacoes_iguais;    // desses, descartados por serem iguais ao anterior
+} BufferTriploTela;
+
 // Estado geral do jogo
+//
+// Travas (adquirir sempre nesta ordem, soltando antes de voltar a uma anterior):
+//   0. tela.trava_publicacao - só em publicar_retrato_tela, antes das demais
+//   1. Tedax.trava      - no máximo um tedax por vez
+//   2. Bancada.trava    - no máximo uma bancada por vez
+//   3. trava_modulos    - pool de módulos, geração, relógio, erros e histogramas
+//   4. trava_ui         - buffer_instrucao_global, mensagem_erro e visao_modulos
+//   5. trava_quadro     - só para cond_tela_atualizada, sem nenhuma outra travada
+// qtd_tedax, qtd_bancadas e a configuração da fase não mudam durante a partida.
 typedef struct {
     Dificuldade dificuldade;    // dificuldade escolhida
     int tempo_total_partida;    // tempo total da partida em segundos
     int tempo_restante;         // tempo restante da partida
     
-    Modulo modulos[100];        // fila de módulos
-    int qtd_modulos;            // quantidade de módulos criados
+    PoolModulos modulos;        // módulos vivos (ver pool.h)
+    int qtd_modulos;            // quantidade de módulos criados na partida
+    int modulos_reciclados;     // resolvidos já devolvidos ao pool (contam como resolvidos)
+    // Módulos vivos por EstadoModulo, na ordem em que entraram no estado:
+    // pendentes em FIFO, em execução e resolvidos do mais antigo ao mais recente
+    // Toda mudança de estado passa por mudar_estado_modulo
+    ListaModulos modulos_por_estado[3];
+    IndiceModulos indice_modulos; // ID -> handle dos módulos vivos (comandos M<n>)
+    OrdemModulos ordem_modulos; // módulos da lista da tela, por slot (ver ordem.h)
+    // Resolvidos antigos saem da lista antes de voltar ao pool: são sempre os
+    // primeiros da lista de resolvidos, até este (ver atualizar_resolvidos_ocultos)
+    HandleModulo ultimo_resolvido_oculto; // ou MODULO_NENHUM
+    int resolvidos_ocultos;     // resolvidos vivos fora da lista da tela
     int proximo_id_modulo;      // próximo ID a ser atribuído
     int modulos_necessarios;    // número de módulos necessários para vencer
     
     // Múltiplos tedax e bancadas
-    Tedax tedax[5];             // até 5 tedax
-    Bancada bancadas[5];        // até 5 bancadas
+    Tedax *tedax;               // qtd_tedax tedax (até MAX_TEDAX)
+    Bancada *bancadas;          // qtd_bancadas bancadas (até MAX_BANCADAS)
     int qtd_tedax;              // quantidade de tedax disponíveis
     int qtd_bancadas;           // quantidade de bancadas disponíveis
     
@@ -138,38 +403,118 @@ typedef struct {
     int ticks_desde_ultimo_modulo; // ticks desde o último módulo gerado
     int intervalo_geracao;      // intervalo entre gerações (em ticks)
     int max_modulos;            // máximo de módulos a gerar (igual a modulos_necessarios)
+    // Enigmas já sorteados, gerados em lote fora da trava (repor_reserva_modulos);
+    // gerar_novo_modulo só copia um deles
+    Modulo reserva_modulos[RESERVA_MODULOS];
+    int qtd_reserva_modulos;
+    
+    // Sorteios da partida: todos derivam de semente (reproduzível), em fluxos
+    // independentes para que nenhum seja compartilhado entre threads
+    uint64_t semente;
+    Aleatorio aleatorio_mural;  // enigmas da reserva (só a thread do mural, sem trava)
+    Aleatorio aleatorio_modulos; // tempos e enigmas fora da reserva (sob trava_modulos)
     
     // Controle do jogo
-    int jogo_rodando;           // flag para indicar se o jogo está rodando
-    int jogo_terminou;          // flag para indicar se o jogo terminou (vitória ou derrota)
+    atomic_int jogo_rodando;    // flag para indicar se o jogo está rodando
+    atomic_int jogo_terminou;   // flag para indicar se o jogo terminou (vitória ou derrota)
+    
+    // Sincronização (ordem das travas descrita acima)
+    Trava trava_modulos;        // protege módulos, geração, tempo_restante e erros_cometidos
+    Trava trava_ui;             // protege buffer_instrucao_global, mensagem_erro e visao_modulos
+    
+    BufferTriploTela tela;      // retratos publicados para a exibição
     
-    // Sincronização
-    pthread_mutex_t mutex_jogo; // mutex para proteger o estado do jogo
+    // Comandos do coordenador: enviados sem travas, aplicados pela simulação
+    FilaComandos comandos;      // vários produtores, consumidor = thread da simulação
+    sem_t sem_comandos;         // acorda a thread da simulação (modo com threads)
+    int pipe_despertar[2];      // acorda o coordenador no fim da partida (modo com threads;
+                                // escrever em [1], ele espera em [0]), ou -1
     pthread_cond_t cond_modulo_disponivel; // condition variable para quando há módulo disponível
-    pthread_cond_t cond_bancada_disponivel; // condition variable para quando há bancada disponível
-    pthread_cond_t cond_tela_atualizada;    // condition variable para atualizar a tela
+    // A exibição dorme em cond_tela_atualizada até haver retrato novo (RETRATO_NOVO)
+    // ou a partida acabar; quem publica avisa (ver avisar_exibicao)
+    Trava trava_quadro;         // mutex de cond_tela_atualizada
+    pthread_cond_t cond_tela_atualizada; // relógio monotônico
+    int fps_maximo;             // limite de quadros por segundo (--fps)
     
     char mensagem_erro[64]; // mensagem de erro para exibir na UI
+    VisaoModulos visao_modulos; // filtros e rolagem da lista de módulos (sob trava_ui)
+    atomic_int linhas_modulos_tela; // linhas de módulos que o painel comporta (quem desenha
+                                    // escreve; o retrato copia só essas)
     int erros_cometidos;    // contador de erros (instruções incorretas)
+    
+    // Registro da partida para replay (ver replay.h), ou NULL se não grava
+    // Só quem aplica os comandos escreve nele
+    FILE *gravacao;
+    
+    // Relógio do motor de simulação (ver simulacao.h)
+    // Só a thread que chama simular_tick usa estes campos
+    int sim_acumulado_ms;   // milissegundos ainda não consumidos por simular_tick
+    long sim_ticks;         // ticks de 0.2s simulados desde o início da partida
+    
+    // Métricas da partida (impressas por imprimir_estatisticas_partida)
+    int modo_reator;            // 1 se a partida roda no reator epoll, 0 com threads
+    int modo_threads;           // 1 se roda com threads (sem simular_tick: ticks pelo relógio real)
+    atomic_long despertares;    // quantas vezes alguma thread/loop acordou durante a partida
+    long long inicio_ns;        // instante de início da partida (relógio monotônico)
+    long long fim_ns;           // instante de fim da partida (0 enquanto roda)
+    Histograma hist_handoff_bancada; // bancada livre com tedax esperando -> tedax ocupa
+    Histograma hist_pendente;   // tempo de um módulo em MOD_PENDENTE até sair dele (sob trava_modulos)
+    
+    // Latência do caminho de um comando: tecla, Enter, aplicação, bancada e quadro
+    long long tecla_comando_ns; // primeira tecla do comando em edição, ou 0 (sob trava_ui)
+    long long ultima_tecla_ns;  // última tecla tratada (sob trava_ui)
+    long long ultimo_enter_ns;  // Enter do último comando aplicado (sob trava_modulos)
+    Histograma hist_digitacao;  // primeira tecla -> Enter (sob trava_modulos)
+    Histograma hist_enter_aplicado; // Enter -> simulação aplica o comando (sob trava_modulos)
+    Histograma hist_enter_bancada;  // Enter -> tedax ocupa a bancada (sob trava_modulos)
+    long long quadro_tecla_ns;  // última tecla e último Enter já vistos num quadro
+    long long quadro_enter_ns;  // (estes e os dois abaixo: só quem desenha)
+    Histograma hist_tecla_quadro;   // tecla -> primeiro quadro desenhado com ela
+    Histograma hist_enter_quadro;   // Enter -> primeiro quadro com o comando aplicado
+    long quadros_desenhados;    // quadros desenhados (só quem desenha)
+    long quadros_contados;      // quadros com bytes contados (ver desenhar_tela)
+    long long bytes_tela;       // bytes mandados ao terminal por esses quadros
+    long bytes_quadro_max;      // maior quadro em bytes
+    int trabalhadores_tedax;    // trabalhadores do escalonador dos tedax (0 se não usado)
+    long tarefas_tedax;         // passos e verificações de tedax executados por eles
+    long tarefas_roubadas;      // tarefas que um trabalhador tirou da fila de outro
+    
+    // Atraso dos laços periódicos do modo com threads (períodos PERIODO_*_NS)
+    // Cada Ritmo só é usado pela sua thread; o relatório é lido depois dos joins
+    Ritmo ritmo_relogio;        // thread principal (1 s)
+    Ritmo ritmo_mural;          // thread_mural (0.2 s)
+    Histograma hist_atraso_tedax; // início do passo de um tedax - prazo do passo
+    long passos_tedax_estourados; // passos que começaram um período inteiro atrasados
 } GameState;
 
 // Funções do jogo
 
 // Inicializa o estado do jogo com a dificuldade escolhida
-// num_tedax: número de tedax (1-3)
-// num_bancadas: número de bancadas (1-3)
-void inicializar_jogo(GameState *g, Dificuldade dificuldade, int num_tedax, int num_bancadas);
+// num_tedax: número de tedax (1-MAX_TEDAX; < 1 usa o da fase)
+// num_bancadas: número de bancadas (1-MAX_BANCADAS; < 1 usa o da fase)
+// semente: semente dos sorteios da partida (0 sorteia uma pelo relógio)
+void inicializar_jogo(GameState *g, Dificuldade dificuldade, int num_tedax, int num_bancadas,
+                      uint64_t semente);
 
 // Finaliza o jogo e libera recursos
 void finalizar_jogo(GameState *g);
 
 // FUTURO: Esta função será uma thread (Mural de Módulos Pendentes)
 // Gera um novo módulo e adiciona ao jogo
+// NOTA: Deve ser chamada com trava_modulos já travada
 void gerar_novo_modulo(GameState *g);
 
+// Gera em lote, fora de trava_modulos, os enigmas que faltam na reserva
+// (quando ela está abaixo da metade); só a cópia para a reserva usa a trava
+// Usa aleatorio_mural: só a thread do mural (ou quem chama simular_tick)
+// NOTA: Não deve ser chamada com trava_modulos travada
+void repor_reserva_modulos(GameState *g);
+
 // Função removida - lógica movida para thread_mural
 
-// Função removida - lógica movida para thread_tedax
+// Função removida - lógica movida para o escalonador dos tedax (escalonador.c)
+
+// As funções abaixo devem ser chamadas com trava_modulos já travada
 
 // Verifica se todos os módulos foram resolvidos
 int todos_modulos_resolvidos(const GameState *g);
@@ -180,6 +525,35 @@ int contar_modulos_resolvidos(const GameState *g);
 // Verifica se há módulos pendentes
 int tem_modulos_pendentes(const GameState *g);
 
+// Muda o estado do módulo, movendo-o para o fim da lista do novo estado
+// Não faz nada se o handle for velho ou o estado já for o mesmo
+void mudar_estado_modulo(GameState *g, HandleModulo handle, EstadoModulo estado);
+
+// Muda o estado do tedax, somando o tempo passado no estado anterior
+// (telemetria: tempo_estado_ms e esperas)
+// NOTA: Deve ser chamada com a trava do tedax já travada
+void mudar_estado_tedax(GameState *g, Tedax *tedax, EstadoTedax estado);
+
+// Instante atual da partida em milissegundos: o relógio do motor de simulação
+// (sim_ticks) quando simular_tick dirige a partida, ou o tempo real desde o
+// início no modo com threads (parado em fim_ns depois do fim)
+// É o relógio da telemetria: no reator e no replay ela se repete exatamente
+long long instante_partida_ms(const GameState *g);
+
+// Segundos desde que o módulo do slot foi resolvido, pelo relógio da partida
+// (a idade é calculada na hora a partir do instante de resolução)
+int idade_modulo_resolvido(const GameState *g, int slot);
+
+// Devolve ao pool os resolvidos que já saíram da tela (TEMPO_EXIBICAO_RESOLVIDO)
+void reciclar_modulos_resolvidos(GameState *g);
+
+// Tira da lista da tela (ordem_modulos) os resolvidos antigos e devolve os que
+// voltaram a caber (chamada pelos passos do mural e do relógio; o retrato só lê)
+void atualizar_resolvidos_ocultos(GameState *g);
+
+// Imprime as métricas da partida (duração, despertares por segundo) em saida
+void imprimir_estatisticas_partida(const GameState *g, FILE *saida);
+
 // Retorna o nome da cor como string
 const char* nome_cor(CorBotao cor);
 
@@ -189,18 +563,21 @@ const char* nome_estado_modulo(EstadoModulo estado);
 // Retorna o nome da dificuldade como string
 const char* nome_dificuldade(Dificuldade dificuldade);
 
-// Funções de thread (serão chamadas pelas threads)
+// Funções de thread (implementadas em threads.c, usam o motor de simulacao.c)
 void* thread_mural(void* arg);
 void* thread_exibicao(void* arg);
-void* thread_tedax(void* arg);
 void* thread_coordenador(void* arg);
 
-// Função auxiliar para processar comando do formato T1B1M1:ppp
-// Retorna 1 se sucesso, 0 se falha
-// Parâmetros de saída: tedax_idx, bancada_idx, modulo_idx, instrucao
-int processar_comando(const char* buffer, GameState *g, 
-                      int *tedax_idx, int *bancada_idx, int *modulo_idx, 
-                      char *instrucao);
+// Trata uma tecla do coordenador: edita o buffer ou aplica o comando no ENTER
+// Retorna 0 se o jogador pediu para sair (tecla 'q'), 1 caso contrário
+// Trava trava_ui só para editar o buffer; no ENTER o comando é interpretado
+// e enviado para g->comandos, sem travar mais nada
+// Setas, PgUp/PgDn, Home/End, Tab e Shift+Tab rolam e filtram a lista de módulos
+int tratar_tecla_coordenador(GameState *g, int ch, char *buffer, int *buffer_len);
+
+// Repassa a linhas_modulos_tela o tamanho do painel da lista no último quadro
+// NOTA: Chamar logo depois de desenhar_tela, na thread que desenha
+void repassar_linhas_modulos(GameState *g);
 
 #endif // GAME_H
 
@@ -0,0 +1,87 @@
+#include "indice.h"
+#include <string.h>
+
+// Sondagem linear a partir de um hash multiplicativo do ID. A remoção puxa para
+// trás as entradas seguintes do mesmo aglomerado, então não há lápides e uma
+// busca sempre para na primeira entrada vazia.
+
+#define MASCARA_INDICE (INDICE_MODULOS_CAPACIDADE - 1)
+
+// Posição inicial do ID na tabela (hash de Fibonacci)
+static int posicao_inicial(int id) {
+    return (int)(((uint32_t)id * 2654435761u) >> (32 - INDICE_MODULOS_BITS));
+}
+
+// Esvazia o índice (entrada vazia: id 0 e MODULO_NENHUM, ambos zero)
+void indice_modulos_limpar(IndiceModulos *indice) {
+    memset(indice->entradas, 0, sizeof(indice->entradas));
+    indice->qtd = 0;
+}
+
+// Registra o handle do módulo com este ID
+int indice_modulos_inserir(IndiceModulos *indice, int id, HandleModulo handle) {
+    if (id <= 0 || indice->qtd >= INDICE_MODULOS_CAPACIDADE - 1) {
+        return 0;
+    }
+    int i = posicao_inicial(id);
+    while (indice->entradas[i].id != 0 && indice->entradas[i].id != id) {
+        i = (i + 1) & MASCARA_INDICE;
+    }
+    if (indice->entradas[i].id == 0) {
+        indice->qtd++;
+    }
+    indice->entradas[i].id = id;
+    indice->entradas[i].handle = handle;
+    return 1;
+}
+
+// Remove o ID do índice
+void indice_modulos_remover(IndiceModulos *indice, int id) {
+    if (id <= 0) {
+        return; // 0 marca entrada vazia: nunca está no índice
+    }
+    int i = posicao_inicial(id);
+    while (indice->entradas[i].id != id) {
+        if (indice->entradas[i].id == 0) {
+            return; // Não está no índice
+        }
+        i = (i + 1) & MASCARA_INDICE;
+    }
+
+    // Puxar para o buraco as entradas seguintes que não ficariam mais alcançáveis
+    int buraco = i;
+    int j = i;
+    for (;;) {
+        j = (j + 1) & MASCARA_INDICE;
+        if (indice->entradas[j].id == 0) {
+            break;
+        }
+        int inicial = posicao_inicial(indice->entradas[j].id);
+        // A entrada em j pode ir para o buraco se sua posição inicial não está
+        // entre o buraco (exclusive) e j (inclusive), contando a volta da tabela
+        int distancia_buraco = (j - buraco) & MASCARA_INDICE;
+        int distancia_inicial = (j - inicial) & MASCARA_INDICE;
+        if (distancia_inicial >= distancia_buraco) {
+            indice->entradas[buraco] = indice->entradas[j];
+            buraco = j;
+        }
+    }
+    indice->entradas[buraco].id = 0;
+    indice->entradas[buraco].handle = MODULO_NENHUM;
+    indice->qtd--;
+}
+
+// Retorna o handle do módulo com este ID, ou MODULO_NENHUM
+HandleModulo indice_modulos_buscar(const IndiceModulos *indice, int id) {
+    if (id <= 0) {
+        return MODULO_NENHUM;
+    }
+    int i = posicao_inicial(id);
+    while (indice->entradas[i].id != 0) {
+        if (indice->entradas[i].id == id) {
+            return indice->entradas[i].handle;
+        }
+        i = (i + 1) & MASCARA_INDICE;
+    }
+    return MODULO_NENHUM;
+}
@@ -0,0 +1,23 @@
+#ifndef INDICE_H
+#define INDICE_H
+
+#include "game.h"
+
+// Índice de ID -> handle dos módulos vivos (tipos em game.h)
+// Mantido por gerar_novo_modulo e por reciclar_modulos_resolvidos
+// NOTA: Funções chamadas com trava_modulos já travada
+
+// Esvazia o índice
+void indice_modulos_limpar(IndiceModulos *indice);
+
+// Registra o handle do módulo com este ID (IDs começam em 1)
+// Retorna 0 se o índice está cheio
+int indice_modulos_inserir(IndiceModulos *indice, int id, HandleModulo handle);
+
+// Remove o ID do índice (não faz nada se ele não estiver lá)
+void indice_modulos_remover(IndiceModulos *indice, int id);
+
+// Retorna o handle do módulo com este ID, ou MODULO_NENHUM
+HandleModulo indice_modulos_buscar(const IndiceModulos *indice, int id);
+
+#endif // INDICE_H
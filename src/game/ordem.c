@@ -0,0 +1,282 @@
+#include "ordem.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Uma árvore de Fenwick por classe, intercaladas: os contadores das
+// ORDEM_CLASSES classes de um mesmo nó ficam juntos, então a busca de um
+// filtro com várias classes lê uma linha de cache por nível da árvore.
+// A posição na árvore segue a ordem de criação: cada módulo novo entra na
+// próxima posição livre, e o índice vai de posição para slot do pool (e de
+// volta). Módulos que voltam para o pool deixam a posição vaga; quando as
+// posições acabam, o índice é refeito com as ocupadas renumeradas em
+// sequência, numa capacidade de ao menos o dobro delas (compacta se sobrou
+// espaço, dobra se não). Assim a capacidade fica em até 2 x POOL_MAX_MODULOS
+// (arredondado para potência de 2) e cada reconstrução, O(n), vem depois de
+// ao menos n inserções.
+
+#define CAPACIDADE_INICIAL 64
+#define CLASSE_MASCARA 0x0F
+#define VARREDURA_MAXIMA 32     // posições olhadas uma a uma antes de descer a árvore
+
+static int classe_de(TipoModulo tipo, EstadoModulo estado) {
+    return (int)tipo * 3 + (int)estado;
+}
+
+// Classes (bits 0..8) que passam nos filtros
+static int mascara_filtro(int filtro_tipo, int filtro_estado) {
+    int mascara = 0;
+    for (int tipo = 0; tipo < 3; tipo++) {
+        for (int estado = 0; estado < 3; estado++) {
+            if ((filtro_tipo < 0 || filtro_tipo == tipo) &&
+                (filtro_estado < 0 || filtro_estado == estado)) {
+                mascara |= 1 << classe_de((TipoModulo)tipo, (EstadoModulo)estado);
+            }
+        }
+    }
+    return mascara;
+}
+
+// Posição do módulo do slot, ou 0 se ele não está no índice
+static int posicao_de(const OrdemModulos *ordem, int slot) {
+    if (!ordem->posicao || slot < 0 || slot >= POOL_MAX_MODULOS) {
+        return 0;
+    }
+    return ordem->posicao[slot];
+}
+
+static void somar(OrdemModulos *ordem, int posicao, int classe, int delta) {
+    for (int i = posicao; i < ordem->capacidade; i += i & -i) {
+        ordem->arvore[i * ORDEM_CLASSES + classe] += delta;
+    }
+    ordem->total[classe] += delta;
+}
+
+// Refaz o índice com espaço para as posições ocupadas e outras tantas livres,
+// renumerando as ocupadas em sequência (na mesma ordem) e refazendo as árvores
+static int refazer(OrdemModulos *ordem) {
+    int capacidade = CAPACIDADE_INICIAL;
+    while (capacidade < 2 * (ordem->ocupadas + 1)) {
+        capacidade *= 2;
+    }
+
+    unsigned char *classe = calloc((size_t)capacidade, 1);
+    int *slot = malloc(sizeof(int) * (size_t)capacidade);
+    int *arvore = calloc((size_t)capacidade * ORDEM_CLASSES, sizeof(int));
+    if (!classe || !slot || !arvore) {
+        free(classe);
+        free(slot);
+        free(arvore);
+        return 0;
+    }
+
+    int nova = 1;
+    for (int i = 1; i < ordem->proxima_posicao; i++) {
+        if (ordem->classe[i] == 0) {
+            continue;
+        }
+        classe[nova] = ordem->classe[i];
+        slot[nova] = ordem->slot[i];
+        ordem->posicao[slot[nova]] = nova;
+        if (classe[nova] & ORDEM_VISIVEL) {
+            arvore[nova * ORDEM_CLASSES + (classe[nova] & CLASSE_MASCARA) - 1]++;
+        }
+        nova++;
+    }
+
+    // Construção linear: cada nó soma o seu valor no pai
+    for (int i = 1; i < capacidade; i++) {
+        int pai = i + (i & -i);
+        if (pai < capacidade) {
+            for (int c = 0; c < ORDEM_CLASSES; c++) {
+                arvore[pai * ORDEM_CLASSES + c] += arvore[i * ORDEM_CLASSES + c];
+            }
+        }
+    }
+
+    free(ordem->classe);
+    free(ordem->slot);
+    free(ordem->arvore);
+    ordem->classe = classe;
+    ordem->slot = slot;
+    ordem->arvore = arvore;
+    ordem->capacidade = capacidade;
+    ordem->proxima_posicao = nova;
+    return 1;
+}
+
+// Começa vazio
+void ordem_modulos_inicializar(OrdemModulos *ordem) {
+    memset(ordem, 0, sizeof(*ordem));
+}
+
+// Libera a memória
+void ordem_modulos_finalizar(OrdemModulos *ordem) {
+    free(ordem->arvore);
+    free(ordem->classe);
+    free(ordem->slot);
+    free(ordem->posicao);
+    memset(ordem, 0, sizeof(*ordem));
+}
+
+// Acrescenta um módulo novo, já na lista, depois de todos os outros
+int ordem_modulos_inserir(OrdemModulos *ordem, int slot, TipoModulo tipo, EstadoModulo estado) {
+    if (slot < 0 || slot >= POOL_MAX_MODULOS) {
+        return 0;
+    }
+    if (!ordem->posicao) {
+        ordem->posicao = calloc(POOL_MAX_MODULOS, sizeof(int));
+        if (!ordem->posicao) {
+            return 0;
+        }
+    }
+    if (ordem->posicao[slot] != 0) {
+        ordem_modulos_remover(ordem, slot); // slot reaproveitado sem passar por remover
+    }
+    if ((ordem->proxima_posicao == 0 || ordem->proxima_posicao >= ordem->capacidade) &&
+        !refazer(ordem)) {
+        return 0;
+    }
+    int posicao = ordem->proxima_posicao++;
+    int classe = classe_de(tipo, estado);
+    ordem->classe[posicao] = (unsigned char)((classe + 1) | ORDEM_VISIVEL);
+    ordem->slot[posicao] = slot;
+    ordem->posicao[slot] = posicao;
+    ordem->ocupadas++;
+    somar(ordem, posicao, classe, 1);
+    return 1;
+}
+
+// Muda a classe do módulo para o novo estado
+void ordem_modulos_mudar_estado(OrdemModulos *ordem, int slot, EstadoModulo estado) {
+    int posicao = posicao_de(ordem, slot);
+    if (posicao == 0) {
+        return;
+    }
+    int anterior = (ordem->classe[posicao] & CLASSE_MASCARA) - 1;
+    int classe = anterior / 3 * 3 + (int)estado;
+    int visivel = ordem->classe[posicao] & ORDEM_VISIVEL;
+    if (visivel && classe != anterior) {
+        somar(ordem, posicao, anterior, -1);
+        somar(ordem, posicao, classe, 1);
+    }
+    ordem->classe[posicao] = (unsigned char)((classe + 1) | visivel);
+}
+
+// Tira o módulo da lista ou o põe de volta
+void ordem_modulos_exibir(OrdemModulos *ordem, int slot, int visivel) {
+    int posicao = posicao_de(ordem, slot);
+    if (posicao == 0) {
+        return;
+    }
+    int estava = (ordem->classe[posicao] & ORDEM_VISIVEL) != 0;
+    if (estava == (visivel != 0)) {
+        return;
+    }
+    int classe = (ordem->classe[posicao] & CLASSE_MASCARA) - 1;
+    somar(ordem, posicao, classe, visivel ? 1 : -1);
+    ordem->classe[posicao] ^= ORDEM_VISIVEL;
+}
+
+// Esquece o módulo; a posição fica vaga até o índice ser refeito
+int ordem_modulos_remover(OrdemModulos *ordem, int slot) {
+    int posicao = posicao_de(ordem, slot);
+    if (posicao == 0) {
+        return 0;
+    }
+    int estava = (ordem->classe[posicao] & ORDEM_VISIVEL) != 0;
+    ordem_modulos_exibir(ordem, slot, 0);
+    ordem->classe[posicao] = 0;
+    ordem->posicao[slot] = 0;
+    ordem->ocupadas--;
+    return estava;
+}
+
+// Quantos módulos da lista passam nos filtros
+int ordem_modulos_contar(const OrdemModulos *ordem, int filtro_tipo, int filtro_estado) {
+    int mascara = mascara_filtro(filtro_tipo, filtro_estado);
+    int total = 0;
+    for (int c = 0; c < ORDEM_CLASSES; c++) {
+        if (mascara & (1 << c)) {
+            total += ordem->total[c];
+        }
+    }
+    return total;
+}
+
+// Posição do k-ésimo módulo da lista que passa na máscara (k válido)
+// Desce a árvore do maior passo para o menor, pulando blocos inteiros de
+// posições cuja contagem (somada nas classes do filtro) ainda não chega a k
+static int buscar_posicao(const OrdemModulos *ordem, int mascara, int k) {
+    int posicao = 0;
+    int restantes = k + 1;
+    for (int passo = ordem->capacidade / 2; passo > 0; passo /= 2) {
+        int proximo = posicao + passo;
+        if (proximo >= ordem->capacidade) {
+            continue;
+        }
+        const int *no = &ordem->arvore[proximo * ORDEM_CLASSES];
+        int soma = 0;
+        for (int c = 0; c < ORDEM_CLASSES; c++) {
+            if (mascara & (1 << c)) {
+                soma += no[c];
+            }
+        }
+        if (soma < restantes) {
+            posicao = proximo;
+            restantes -= soma;
+        }
+    }
+    return posicao + 1;
+}
+
+// Slot do k-ésimo módulo da lista que passa nos filtros
+int ordem_modulos_buscar(const OrdemModulos *ordem, int filtro_tipo, int filtro_estado, int k) {
+    if (k < 0 || k >= ordem_modulos_contar(ordem, filtro_tipo, filtro_estado)) {
+        return -1;
+    }
+    int posicao = buscar_posicao(ordem, mascara_filtro(filtro_tipo, filtro_estado), k);
+    return posicao < ordem->proxima_posicao ? ordem->slot[posicao] : -1;
+}
+
+// Quantos módulos da lista passam nos filtros até a posição (soma de prefixo)
+static int contar_ate(const OrdemModulos *ordem, int mascara, int posicao) {
+    int total = 0;
+    for (int i = posicao; i > 0; i -= i & -i) {
+        const int *no = &ordem->arvore[i * ORDEM_CLASSES];
+        for (int c = 0; c < ORDEM_CLASSES; c++) {
+            if (mascara & (1 << c)) {
+                total += no[c];
+            }
+        }
+    }
+    return total;
+}
+
+// Slot do próximo módulo da lista depois do slot dado que passa nos filtros, ou -1
+// Os vizinhos costumam estar logo adiante: olha as próximas posições uma a uma
+// e, se estiverem longe (filtro raro), cai para a contagem e a busca na árvore
+int ordem_modulos_proximo(const OrdemModulos *ordem, int filtro_tipo, int filtro_estado, int slot) {
+    int posicao = posicao_de(ordem, slot);
+    if (posicao == 0) {
+        return -1;
+    }
+    int mascara = mascara_filtro(filtro_tipo, filtro_estado);
+    int fim = posicao + 1 + VARREDURA_MAXIMA;
+    if (fim > ordem->proxima_posicao) {
+        fim = ordem->proxima_posicao;
+    }
+    for (int i = posicao + 1; i < fim; i++) {
+        int classe = ordem->classe[i];
+        if ((classe & ORDEM_VISIVEL) && (mascara & (1 << ((classe & CLASSE_MASCARA) - 1)))) {
+            return ordem->slot[i];
+        }
+    }
+    if (fim >= ordem->proxima_posicao) {
+        return -1;
+    }
+    int k = contar_ate(ordem, mascara, fim - 1);
+    if (k >= ordem_modulos_contar(ordem, filtro_tipo, filtro_estado)) {
+        return -1;
+    }
+    return ordem->slot[buscar_posicao(ordem, mascara, k)];
+}
@@ -0,0 +1,41 @@
+#ifndef ORDEM_H
+#define ORDEM_H
+
+#include "game.h"
+
+// Índice ordenado dos módulos da lista da tela (tipos em game.h)
+// Mantido por gerar_novo_modulo, mudar_estado_modulo, reciclar_modulos_resolvidos
+// e atualizar_resolvidos_ocultos; filtro_tipo/filtro_estado -1 aceitam todos
+// NOTA: Funções chamadas com trava_modulos já travada
+
+// Começa vazio (a memória é alocada no primeiro módulo)
+void ordem_modulos_inicializar(OrdemModulos *ordem);
+
+// Libera a memória
+void ordem_modulos_finalizar(OrdemModulos *ordem);
+
+// Acrescenta um módulo novo (slot do pool), já na lista, depois de todos os outros
+// Retorna 0 se faltou memória (o módulo só não aparece na lista)
+int ordem_modulos_inserir(OrdemModulos *ordem, int slot, TipoModulo tipo, EstadoModulo estado);
+
+// Muda a classe do módulo para o novo estado
+void ordem_modulos_mudar_estado(OrdemModulos *ordem, int slot, EstadoModulo estado);
+
+// Tira o módulo da lista (visivel = 0) ou o põe de volta, sem esquecer a classe
+void ordem_modulos_exibir(OrdemModulos *ordem, int slot, int visivel);
+
+// Esquece o módulo (antes de o slot voltar para o pool)
+// Retorna 1 se ele estava na lista
+int ordem_modulos_remover(OrdemModulos *ordem, int slot);
+
+// Quantos módulos da lista passam nos filtros
+int ordem_modulos_contar(const OrdemModulos *ordem, int filtro_tipo, int filtro_estado);
+
+// Slot do k-ésimo (a partir de 0) módulo da lista que passa nos filtros, ou -1
+int ordem_modulos_buscar(const OrdemModulos *ordem, int filtro_tipo, int filtro_estado, int k);
+
+// Slot do próximo módulo da lista depois do slot dado que passa nos filtros, ou -1
+// Para percorrer a lista a partir de um ordem_modulos_buscar
+int ordem_modulos_proximo(const OrdemModulos *ordem, int filtro_tipo, int filtro_estado, int slot);
+
+#endif // ORDEM_H
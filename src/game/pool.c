@@ -0,0 +1,242 @@
+#include "pool.h"
+#include <stdlib.h>
+
+// Um handle junta a geração do slot (16 bits altos) e o índice do slot (16 bits
+// baixos). A geração começa em 1 e avança a cada liberação, pulando 0, então
+// MODULO_NENHUM (0) nunca é um handle válido.
+
+static HandleModulo montar_handle(const PoolModulos *pool, int slot) {
+    return ((HandleModulo)pool->geracao[slot] << 16) | (HandleModulo)slot;
+}
+
+static int slot_do_handle(HandleModulo handle) {
+    return (int)(handle & 0xFFFF);
+}
+
+// Retorna o slot do handle se ele ainda vale, ou -1
+static int slot_valido(const PoolModulos *pool, HandleModulo handle) {
+    int slot = slot_do_handle(handle);
+    if (handle == MODULO_NENHUM || slot >= pool->qtd_slabs * POOL_MODULOS_POR_SLAB) {
+        return -1;
+    }
+    if (!pool->em_uso[slot] || pool->geracao[slot] != (uint16_t)(handle >> 16)) {
+        return -1;
+    }
+    return slot;
+}
+
+// Prepara o pool vazio (nenhum slab alocado)
+void pool_modulos_inicializar(PoolModulos *pool) {
+    for (int i = 0; i < POOL_MAX_SLABS; i++) {
+        pool->slabs[i] = NULL;
+    }
+    pool->qtd_slabs = 0;
+    pool->livre = -1;
+    pool->primeiro = -1;
+    pool->ultimo = -1;
+    pool->qtd_vivos = 0;
+}
+
+// Libera todos os slabs
+void pool_modulos_finalizar(PoolModulos *pool) {
+    for (int i = 0; i < pool->qtd_slabs; i++) {
+        free(pool->slabs[i]);
+        pool->slabs[i] = NULL;
+    }
+    pool->qtd_slabs = 0;
+    pool->livre = -1;
+    pool->primeiro = -1;
+    pool->ultimo = -1;
+    pool->qtd_vivos = 0;
+}
+
+// Aloca mais um slab e coloca seus slots na lista livre
+// Retorna 0 se o pool já tem POOL_MAX_SLABS ou faltou memória
+static int crescer_pool(PoolModulos *pool) {
+    if (pool->qtd_slabs >= POOL_MAX_SLABS) {
+        return 0;
+    }
+    Modulo *slab = malloc(sizeof(Modulo) * POOL_MODULOS_POR_SLAB);
+    if (!slab) {
+        return 0;
+    }
+
+    int base = pool->qtd_slabs * POOL_MODULOS_POR_SLAB;
+    pool->slabs[pool->qtd_slabs++] = slab;
+
+    // Empilhar de trás para frente para que o slot mais baixo saia primeiro
+    for (int i = POOL_MODULOS_POR_SLAB - 1; i >= 0; i--) {
+        int slot = base + i;
+        pool->geracao[slot] = 1;
+        pool->em_uso[slot] = 0;
+        pool->proximo[slot] = pool->livre;
+        pool->livre = slot;
+    }
+    return 1;
+}
+
+// Reserva um slot e o coloca no fim da ordem de criação
+HandleModulo pool_modulos_alocar(PoolModulos *pool) {
+    if (pool->livre < 0 && !crescer_pool(pool)) {
+        return MODULO_NENHUM;
+    }
+
+    int slot = pool->livre;
+    pool->livre = pool->proximo[slot];
+
+    pool->em_uso[slot] = 1;
+    pool->anterior[slot] = pool->ultimo;
+    pool->proximo[slot] = -1;
+    if (pool->ultimo >= 0) {
+        pool->proximo[pool->ultimo] = slot;
+    } else {
+        pool->primeiro = slot;
+    }
+    pool->ultimo = slot;
+    pool->qtd_vivos++;
+
+    return montar_handle(pool, slot);
+}
+
+// Devolve o módulo para a lista livre; o handle e suas cópias deixam de valer
+void pool_modulos_liberar(PoolModulos *pool, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0) {
+        return;
+    }
+
+    // Tirar da ordem de criação
+    int anterior = pool->anterior[slot];
+    int proximo = pool->proximo[slot];
+    if (anterior >= 0) {
+        pool->proximo[anterior] = proximo;
+    } else {
+        pool->primeiro = proximo;
+    }
+    if (proximo >= 0) {
+        pool->anterior[proximo] = anterior;
+    } else {
+        pool->ultimo = anterior;
+    }
+
+    // Nova geração: handles antigos para este slot passam a ser rejeitados
+    pool->geracao[slot]++;
+    if (pool->geracao[slot] == 0) {
+        pool->geracao[slot] = 1;
+    }
+    pool->em_uso[slot] = 0;
+    pool->proximo[slot] = pool->livre;
+    pool->livre = slot;
+    pool->qtd_vivos--;
+}
+
+// Retorna o módulo do handle, ou NULL se o handle é MODULO_NENHUM ou velho
+Modulo* pool_modulos_obter(const PoolModulos *pool, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0) {
+        return NULL;
+    }
+    return &pool->slabs[slot / POOL_MODULOS_POR_SLAB][slot % POOL_MODULOS_POR_SLAB];
+}
+
+// Slot do handle, ou -1 se o handle é MODULO_NENHUM ou velho
+int pool_modulos_slot(const PoolModulos *pool, HandleModulo handle) {
+    return slot_valido(pool, handle);
+}
+
+// Handle atual do módulo no slot, ou MODULO_NENHUM se o slot está livre
+HandleModulo pool_modulos_handle(const PoolModulos *pool, int slot) {
+    if (slot < 0 || slot >= pool->qtd_slabs * POOL_MODULOS_POR_SLAB || !pool->em_uso[slot]) {
+        return MODULO_NENHUM;
+    }
+    return montar_handle(pool, slot);
+}
+
+// Primeiro módulo vivo na ordem de criação, ou MODULO_NENHUM
+HandleModulo pool_modulos_primeiro(const PoolModulos *pool) {
+    return pool->primeiro >= 0 ? montar_handle(pool, pool->primeiro) : MODULO_NENHUM;
+}
+
+// Módulo vivo criado depois de handle, ou MODULO_NENHUM
+HandleModulo pool_modulos_proximo(const PoolModulos *pool, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0 || pool->proximo[slot] < 0) {
+        return MODULO_NENHUM;
+    }
+    return montar_handle(pool, pool->proximo[slot]);
+}
+
+// Prepara a lista vazia
+void pool_lista_inicializar(ListaModulos *lista) {
+    lista->primeiro = -1;
+    lista->ultimo = -1;
+    lista->qtd = 0;
+}
+
+// Coloca o módulo no fim da lista
+void pool_lista_inserir(PoolModulos *pool, ListaModulos *lista, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0) {
+        return;
+    }
+    pool->lista_anterior[slot] = lista->ultimo;
+    pool->lista_proximo[slot] = -1;
+    if (lista->ultimo >= 0) {
+        pool->lista_proximo[lista->ultimo] = slot;
+    } else {
+        lista->primeiro = slot;
+    }
+    lista->ultimo = slot;
+    lista->qtd++;
+}
+
+// Tira o módulo da lista (ele precisa estar nela)
+void pool_lista_remover(PoolModulos *pool, ListaModulos *lista, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0) {
+        return;
+    }
+    int anterior = pool->lista_anterior[slot];
+    int proximo = pool->lista_proximo[slot];
+    if (anterior >= 0) {
+        pool->lista_proximo[anterior] = proximo;
+    } else {
+        lista->primeiro = proximo;
+    }
+    if (proximo >= 0) {
+        pool->lista_anterior[proximo] = anterior;
+    } else {
+        lista->ultimo = anterior;
+    }
+    pool->lista_anterior[slot] = -1;
+    pool->lista_proximo[slot] = -1;
+    lista->qtd--;
+}
+
+// Primeiro módulo da lista, ou MODULO_NENHUM
+HandleModulo pool_lista_primeiro(const PoolModulos *pool, const ListaModulos *lista) {
+    return lista->primeiro >= 0 ? montar_handle(pool, lista->primeiro) : MODULO_NENHUM;
+}
+
+// Módulo seguinte na lista em que handle está, ou MODULO_NENHUM
+HandleModulo pool_lista_proximo(const PoolModulos *pool, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0 || pool->lista_proximo[slot] < 0) {
+        return MODULO_NENHUM;
+    }
+    return montar_handle(pool, pool->lista_proximo[slot]);
+}
+
+// Último módulo da lista, ou MODULO_NENHUM
+HandleModulo pool_lista_ultimo(const PoolModulos *pool, const ListaModulos *lista) {
+    return lista->ultimo >= 0 ? montar_handle(pool, lista->ultimo) : MODULO_NENHUM;
+}
+
+// Módulo anterior na lista em que handle está, ou MODULO_NENHUM
+HandleModulo pool_lista_anterior(const PoolModulos *pool, HandleModulo handle) {
+    int slot = slot_valido(pool, handle);
+    if (slot < 0 || pool->lista_anterior[slot] < 0) {
+        return MODULO_NENHUM;
+    }
+    return montar_handle(pool, pool->lista_anterior[slot]);
+}
@@ -0,0 +1,53 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "game.h"
+
+// Pool de módulos (tipos em game.h): slabs alocados sob demanda, lista livre
+// para reaproveitar slots e handles com geração para detectar referências velhas
+// NOTA: Funções chamadas com trava_modulos já travada (exceto inicializar/finalizar)
+
+// Prepara o pool vazio (nenhum slab alocado)
+void pool_modulos_inicializar(PoolModulos *pool);
+
+// Libera todos os slabs
+void pool_modulos_finalizar(PoolModulos *pool);
+
+// Reserva um slot e o coloca no fim da ordem de criação
+// Retorna o handle do módulo (conteúdo não inicializado) ou MODULO_NENHUM se o
+// pool está cheio (POOL_MAX_MODULOS vivos) ou faltou memória para um slab
+HandleModulo pool_modulos_alocar(PoolModulos *pool);
+
+// Devolve o módulo para a lista livre; o handle e suas cópias deixam de valer
+void pool_modulos_liberar(PoolModulos *pool, HandleModulo handle);
+
+// Retorna o módulo do handle, ou NULL se o handle é MODULO_NENHUM ou velho
+// (o slot foi liberado e talvez reaproveitado por outro módulo)
+Modulo* pool_modulos_obter(const PoolModulos *pool, HandleModulo handle);
+
+// Slot do handle, para os campos quentes do pool (pool->estado[slot], ...),
+// ou -1 se o handle é MODULO_NENHUM ou velho
+int pool_modulos_slot(const PoolModulos *pool, HandleModulo handle);
+
+// Handle atual do módulo no slot, ou MODULO_NENHUM se o slot está livre
+// (para quem guarda slots, como o índice da lista da tela)
+HandleModulo pool_modulos_handle(const PoolModulos *pool, int slot);
+
+// Percorre os módulos vivos na ordem de criação:
+//   for (h = pool_modulos_primeiro(p); h != MODULO_NENHUM; h = pool_modulos_proximo(p, h))
+// Para liberar durante o percurso, pegue o próximo antes de liberar o atual
+HandleModulo pool_modulos_primeiro(const PoolModulos *pool);
+HandleModulo pool_modulos_proximo(const PoolModulos *pool, HandleModulo handle);
+
+// Listas intrusivas (ListaModulos): inserir no fim, remover e percorrer em O(1)
+// por passo. Liberar um módulo exige tirá-lo antes da lista em que está.
+void pool_lista_inicializar(ListaModulos *lista);
+void pool_lista_inserir(PoolModulos *pool, ListaModulos *lista, HandleModulo handle);
+void pool_lista_remover(PoolModulos *pool, ListaModulos *lista, HandleModulo handle);
+HandleModulo pool_lista_primeiro(const PoolModulos *pool, const ListaModulos *lista);
+HandleModulo pool_lista_proximo(const PoolModulos *pool, HandleModulo handle);
+// Percurso de trás para frente (do último inserido para o primeiro)
+HandleModulo pool_lista_ultimo(const PoolModulos *pool, const ListaModulos *lista);
+HandleModulo pool_lista_anterior(const PoolModulos *pool, HandleModulo handle);
+
+#endif // POOL_H
@@ -0,0 +1,282 @@
+#include "retrato.h"
+#include "pool.h"
+#include "ordem.h"
+#include "../modulos/modulos.h"
+#include <string.h>
+
+// Prepara o buffer triplo com retratos vazios
+void inicializar_retratos_tela(BufferTriploTela *tela) {
+    memset(tela->retratos, 0, sizeof(tela->retratos));
+    tela->escrita = 0;
+    atomic_init(&tela->pronto, 1);
+    tela->leitura = 2;
+    trava_inicializar(&tela->trava_publicacao);
+    tela->publicado = -1;
+    tela->publicacoes = 0;
+    tela->publicacoes_iguais = 0;
+}
+
+// Destroi o buffer triplo
+void finalizar_retratos_tela(BufferTriploTela *tela) {
+    trava_destruir(&tela->trava_publicacao);
+}
+
+// Copia a janela da lista de módulos que o painel mostra: só as linhas que
+// cabem nele (linhas_modulos_tela), a partir da primeira_linha da visão, entre
+// os módulos da lista (ordem_modulos) que passam nos filtros
+// O custo depende dessas linhas, não de quantos módulos existem
+// Retorna a maior primeira_linha útil (a última página cheia)
+// NOTA: Deve ser chamada com trava_modulos já travada
+static int copiar_modulos_retrato(const GameState *g, RetratoTela *r, const VisaoModulos *visao) {
+    const PoolModulos *pool = &g->modulos;
+    const OrdemModulos *ordem = &g->ordem_modulos;
+    r->resolvidos = contar_modulos_resolvidos(g);
+    
+    r->qtd_modulos = g->qtd_modulos;
+    r->resolvidos_removidos = g->modulos_reciclados + g->resolvidos_ocultos;
+    r->filtro_tipo = visao->filtro_tipo;
+    r->filtro_estado = visao->filtro_estado;
+    r->qtd_filtrados = ordem_modulos_contar(ordem, visao->filtro_tipo, visao->filtro_estado);
+    
+    int linhas = atomic_load_explicit(&g->linhas_modulos_tela, memory_order_relaxed);
+    if (linhas < 1) linhas = 1;
+    if (linhas > RETRATO_MAX_MODULOS) linhas = RETRATO_MAX_MODULOS;
+    int ultima_primeira = r->qtd_filtrados > linhas ? r->qtd_filtrados - linhas : 0;
+    r->primeira_linha = visao->primeira_linha < ultima_primeira ? visao->primeira_linha
+                                                                : ultima_primeira;
+    
+    // A primeira linha é uma busca no índice ordenado; as seguintes andam por
+    // ele a partir dela. O Modulo (frio) só é lido para as linhas copiadas
+    r->qtd_linhas = 0;
+    for (int slot = ordem_modulos_buscar(ordem, visao->filtro_tipo, visao->filtro_estado,
+                                         r->primeira_linha);
+         slot >= 0 && r->qtd_linhas < linhas;
+         slot = ordem_modulos_proximo(ordem, visao->filtro_tipo, visao->filtro_estado, slot)) {
+        const Modulo *mod = pool_modulos_obter(pool, pool_modulos_handle(pool, slot));
+        if (!mod) {
+            continue;
+        }
+        LinhaModuloRetrato *linha = &r->linhas[r->qtd_linhas++];
+        linha->id = mod->id;
+        linha->estado = pool->estado[slot];
+        linha->tempo_total = pool->tempo_total[slot];
+        obter_info_exibicao_modulo(mod, linha->info, sizeof(linha->info));
+    }
+    return ultima_primeira;
+}
+
+// Compara dois retratos pelo que a tela mostra (e pelas marcas de tecla/Enter,
+// que também pedem quadro: a latência é medida no primeiro que as mostra)
+// As linhas além das contagens são restos de retratos antigos e não entram
+static int retratos_iguais(const RetratoTela *a, const RetratoTela *b) {
+    if (a->dificuldade != b->dificuldade || a->tempo_restante != b->tempo_restante ||
+        a->resolvidos != b->resolvidos || a->modulos_necessarios != b->modulos_necessarios ||
+        a->qtd_tedax != b->qtd_tedax || a->qtd_linhas_tedax != b->qtd_linhas_tedax ||
+        a->qtd_bancadas != b->qtd_bancadas || a->qtd_linhas_bancadas != b->qtd_linhas_bancadas ||
+        a->qtd_modulos != b->qtd_modulos || a->qtd_linhas != b->qtd_linhas ||
+        a->resolvidos_removidos != b->resolvidos_removidos ||
+        a->filtro_tipo != b->filtro_tipo || a->filtro_estado != b->filtro_estado ||
+        a->qtd_filtrados != b->qtd_filtrados || a->primeira_linha != b->primeira_linha ||
+        a->tecla_ns != b->tecla_ns || a->enter_ns != b->enter_ns ||
+        strcmp(a->buffer_instrucao, b->buffer_instrucao) != 0 ||
+        strcmp(a->mensagem_erro, b->mensagem_erro) != 0) {
+        return 0;
+    }
+    
+    for (int i = 0; i < a->qtd_linhas_tedax; i++) {
+        const LinhaTedaxRetrato *x = &a->tedax[i], *y = &b->tedax[i];
+        if (x->id != y->id || x->estado != y->estado || x->bancada_id != y->bancada_id ||
+            x->modulo_id != y->modulo_id || x->fila_modulo_id != y->fila_modulo_id) {
+            return 0;
+        }
+        if (x->modulo_id >= 0 && (x->modulo_tempo_total != y->modulo_tempo_total ||
+                                  x->modulo_tempo_restante != y->modulo_tempo_restante)) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < a->qtd_linhas_bancadas; i++) {
+        const LinhaBancadaRetrato *x = &a->bancadas[i], *y = &b->bancadas[i];
+        if (x->id != y->id || x->estado != y->estado ||
+            x->tedax_ocupando != y->tedax_ocupando || x->tedax_esperando != y->tedax_esperando) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < a->qtd_linhas; i++) {
+        const LinhaModuloRetrato *x = &a->linhas[i], *y = &b->linhas[i];
+        if (x->id != y->id || x->estado != y->estado || x->tempo_total != y->tempo_total ||
+            strcmp(x->info, y->info) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Monta um retrato do estado atual e o publica para a exibição
+int publicar_retrato_tela(GameState *g, const char *buffer_instrucao) {
+    BufferTriploTela *tela = &g->tela;
+    trava_travar(&tela->trava_publicacao);
+    RetratoTela *r = &tela->retratos[tela->escrita];
+    
+    // Filtros e rolagem da lista de módulos, antes das travas dos módulos
+    trava_travar(&g->trava_ui);
+    VisaoModulos visao = g->visao_modulos;
+    trava_destravar(&g->trava_ui);
+    
+    r->dificuldade = g->dificuldade;
+    r->modulos_necessarios = g->modulos_necessarios;
+    r->qtd_tedax = g->qtd_tedax;
+    r->qtd_bancadas = g->qtd_bancadas;
+    r->qtd_linhas_tedax = g->qtd_tedax < RETRATO_MAX_TEDAX ? g->qtd_tedax : RETRATO_MAX_TEDAX;
+    r->qtd_linhas_bancadas = g->qtd_bancadas < RETRATO_MAX_BANCADAS ? g->qtd_bancadas
+                                                                   : RETRATO_MAX_BANCADAS;
+    
+    // Tedax antes dos módulos: se um módulo voltar para o pool nesse meio-tempo,
+    // o handle copiado fica velho e a linha sai sem módulo
+    HandleModulo modulo_tedax[RETRATO_MAX_TEDAX], fila_tedax[RETRATO_MAX_TEDAX];
+    for (int i = 0; i < r->qtd_linhas_tedax; i++) {
+        Tedax *t = &g->tedax[i];
+        LinhaTedaxRetrato *linha = &r->tedax[i];
+        trava_travar(&t->trava);
+        linha->id = t->id;
+        linha->estado = t->estado;
+        linha->bancada_id = t->bancada_atual >= 0 ? g->bancadas[t->bancada_atual].id : 0;
+        modulo_tedax[i] = t->modulo_atual;
+        fila_tedax[i] = t->qtd_fila > 0 ? t->fila_modulos[0] : MODULO_NENHUM;
+        trava_destravar(&t->trava);
+    }
+    
+    for (int i = 0; i < r->qtd_linhas_bancadas; i++) {
+        Bancada *b = &g->bancadas[i];
+        LinhaBancadaRetrato *linha = &r->bancadas[i];
+        trava_travar(&b->trava);
+        linha->id = b->id;
+        linha->estado = b->estado;
+        linha->tedax_ocupando = b->tedax_ocupando;
+        linha->tedax_esperando = b->tedax_esperando;
+        trava_destravar(&b->trava);
+    }
+    
+    trava_travar(&g->trava_modulos);
+    r->tempo_restante = g->tempo_restante;
+    for (int i = 0; i < r->qtd_linhas_tedax; i++) {
+        LinhaTedaxRetrato *linha = &r->tedax[i];
+        // Sem módulo os tempos ficam zerados: a tela compara as linhas byte a byte
+        linha->modulo_id = -1;
+        linha->modulo_tempo_total = 0;
+        linha->modulo_tempo_restante = 0;
+        linha->fila_modulo_id = -1;
+        const Modulo *mod = pool_modulos_obter(&g->modulos, modulo_tedax[i]);
+        if (mod) {
+            int slot = pool_modulos_slot(&g->modulos, modulo_tedax[i]);
+            linha->modulo_id = mod->id;
+            linha->modulo_tempo_total = g->modulos.tempo_total[slot];
+            linha->modulo_tempo_restante = g->modulos.tempo_restante[slot];
+        }
+        const Modulo *fila = pool_modulos_obter(&g->modulos, fila_tedax[i]);
+        if (fila) {
+            linha->fila_modulo_id = fila->id;
+        }
+    }
+    int ultima_primeira = copiar_modulos_retrato(g, r, &visao);
+    r->enter_ns = g->ultimo_enter_ns;
+    trava_destravar(&g->trava_modulos);
+    
+    trava_travar(&g->trava_ui);
+    strncpy(r->buffer_instrucao, buffer_instrucao, sizeof(r->buffer_instrucao) - 1);
+    r->buffer_instrucao[sizeof(r->buffer_instrucao) - 1] = '\0';
+    memcpy(r->mensagem_erro, g->mensagem_erro, sizeof(r->mensagem_erro));
+    r->tecla_ns = g->ultima_tecla_ns;
+    // Rolagem além do fim da lista volta para a última página (se os filtros
+    // não mudaram enquanto o retrato era montado)
+    VisaoModulos *v = &g->visao_modulos;
+    if (v->filtro_tipo == visao.filtro_tipo && v->filtro_estado == visao.filtro_estado) {
+        v->ultima_primeira_linha = ultima_primeira;
+        if (v->primeira_linha > ultima_primeira) {
+            v->primeira_linha = ultima_primeira;
+        }
+    }
+    trava_destravar(&g->trava_ui);
+    
+    // Nada mudou desde o último publicado: não há quadro a desenhar
+    // (o último publicado só é escrito de novo depois de outra publicação, e a
+    // exibição só o lê, então a comparação não precisa de mais nada)
+    tela->publicacoes++;
+    if (tela->publicado >= 0 && retratos_iguais(r, &tela->retratos[tela->publicado])) {
+        tela->publicacoes_iguais++;
+        trava_destravar(&tela->trava_publicacao);
+        return 0;
+    }
+    
+    // Publicar: o retrato escrito vira o "pronto" e o antigo "pronto" passa a
+    // ser o próximo a ser escrito; RETRATO_NOVO marca o quadro como sujo
+    tela->publicado = tela->escrita;
+    int anterior = atomic_exchange_explicit(&tela->pronto, tela->escrita | RETRATO_NOVO,
+                                            memory_order_acq_rel);
+    tela->escrita = anterior & ~RETRATO_NOVO;
+    
+    trava_destravar(&tela->trava_publicacao);
+    avisar_exibicao(g);
+    return 1;
+}
+
+// Acorda a exibição (retrato novo ou fim da partida)
+void avisar_exibicao(GameState *g) {
+    trava_travar(&g->trava_quadro);
+    pthread_cond_broadcast(&g->cond_tela_atualizada);
+    trava_destravar(&g->trava_quadro);
+}
+
+// Há retrato publicado que a exibição ainda não pegou?
+int retrato_tela_pendente(GameState *g) {
+    return (atomic_load_explicit(&g->tela.pronto, memory_order_acquire) & RETRATO_NOVO) != 0;
+}
+
+// Dorme até haver retrato novo ou a partida acabar
+int esperar_retrato_tela(GameState *g) {
+    trava_travar(&g->trava_quadro);
+    while (!retrato_tela_pendente(g) && g->jogo_rodando && !g->jogo_terminou) {
+        trava_esperar_condicao(&g->trava_quadro, &g->cond_tela_atualizada, NULL);
+    }
+    trava_destravar(&g->trava_quadro);
+    return g->jogo_rodando && !g->jogo_terminou;
+}
+
+// Retorna o retrato publicado mais recente, sem travas
+const RetratoTela* obter_retrato_tela(GameState *g) {
+    BufferTriploTela *tela = &g->tela;
+    
+    // Só troca se houver retrato novo; senão continua desenhando o atual
+    if (atomic_load_explicit(&tela->pronto, memory_order_relaxed) & RETRATO_NOVO) {
+        int anterior = atomic_exchange_explicit(&tela->pronto, tela->leitura,
+                                                memory_order_acq_rel);
+        tela->leitura = anterior & ~RETRATO_NOVO;
+    }
+    
+    return &tela->retratos[tela->leitura];
+}
+
+// Mede a latência do que o quadro recém-desenhado mostra pela primeira vez
+void registrar_quadro_desenhado(GameState *g, const RetratoTela *r, long bytes) {
+    g->quadros_desenhados++;
+    if (bytes >= 0) {
+        g->quadros_contados++;
+        g->bytes_tela += bytes;
+        if (bytes > g->bytes_quadro_max) {
+            g->bytes_quadro_max = bytes;
+        }
+    }
+    
+    if (r->tecla_ns <= g->quadro_tecla_ns && r->enter_ns <= g->quadro_enter_ns) {
+        return; // Nada novo desde o último quadro
+    }
+    
+    long long agora = agora_ns();
+    if (r->tecla_ns > g->quadro_tecla_ns) {
+        histograma_registrar(&g->hist_tecla_quadro, agora - r->tecla_ns);
+        g->quadro_tecla_ns = r->tecla_ns;
+    }
+    if (r->enter_ns > g->quadro_enter_ns) {
+        histograma_registrar(&g->hist_enter_quadro, agora - r->enter_ns);
+        g->quadro_enter_ns = r->enter_ns;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef RETRATO_H
+#define RETRATO_H
+
+#include "game.h"
+
+// Retrato da tela (tipos em game.h): publicação por buffer triplo
+
+// Prepara o buffer triplo com retratos vazios
+void inicializar_retratos_tela(BufferTriploTela *tela);
+
+// Destroi o buffer triplo
+void finalizar_retratos_tela(BufferTriploTela *tela);
+
+// Monta um retrato do estado atual e o publica para a exibição
+// buffer_instrucao é o buffer do coordenador, copiado sob trava_ui
+// Trava cada domínio do jogo por vez, na ordem de game.h
+// Se o retrato é igual ao último publicado ele é descartado; senão é marcado
+// como novo (RETRATO_NOVO) e a exibição é acordada
+// Retorna 1 se publicou, 0 se não havia mudança
+// NOTA: Não pode ser chamada com nenhuma trava do jogo travada
+int publicar_retrato_tela(GameState *g, const char *buffer_instrucao);
+
+// Acorda a exibição em cond_tela_atualizada (publicar_retrato_tela já faz isso;
+// chamar também quando a partida acaba, para ela sair do laço)
+void avisar_exibicao(GameState *g);
+
+// 1 se há retrato publicado que obter_retrato_tela ainda não pegou
+int retrato_tela_pendente(GameState *g);
+
+// Dorme em cond_tela_atualizada até haver retrato novo ou a partida acabar
+// Retorna 1 se há retrato novo, 0 se a partida acabou
+int esperar_retrato_tela(GameState *g);
+
+// Retorna o retrato publicado mais recente, sem travas
+// O retrato continua válido até a próxima chamada
+// NOTA: Só uma thread (a de exibição) pode chamar esta função
+const RetratoTela* obter_retrato_tela(GameState *g);
+
+// Mede a latência do que o quadro recém-desenhado mostra pela primeira vez: a
+// última tecla (tecla -> quadro) e o último comando aplicado (Enter -> quadro)
+// Com várias teclas entre dois quadros, só a mais recente é medida
+// Conta também os bytes que o quadro mandou para o terminal (o retorno de
+// desenhar_tela; negativo se não há contagem)
+// Chamar logo depois de desenhar_tela(r)
+// NOTA: Só a thread que desenha pode chamar esta função
+void registrar_quadro_desenhado(GameState *g, const RetratoTela *r, long bytes);
+
+#endif // RETRATO_H
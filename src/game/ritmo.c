@@ -0,0 +1,58 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ritmo.h"
+#include <errno.h>
+
+// Começa o ritmo agora: o primeiro prazo é daqui a um período
+void ritmo_iniciar(Ritmo *r, long long periodo_ns) {
+    r->periodo_ns = periodo_ns;
+    r->prazo_ns = agora_ns() + periodo_ns;
+    r->estouros = 0;
+    histograma_zerar(&r->atraso);
+}
+
+// Prazo atual como timespec do relógio monotônico
+void ritmo_prazo(const Ritmo *r, struct timespec *ts) {
+    ts->tv_sec = r->prazo_ns / 1000000000LL;
+    ts->tv_nsec = r->prazo_ns % 1000000000LL;
+}
+
+// Registra o atraso e avança para o próximo prazo futuro
+int ritmo_avancar(Ritmo *r) {
+    long long atraso = agora_ns() - r->prazo_ns;
+    if (atraso < 0) {
+        return 0;
+    }
+    histograma_registrar(&r->atraso, atraso);
+
+    // Os prazos continuam na grade original: quem atrasou mais de um período
+    // recebe os períodos perdidos de uma vez em vez de deslocar os seguintes
+    int vencidos = 1 + (int)(atraso / r->periodo_ns);
+    r->prazo_ns += (long long)vencidos * r->periodo_ns;
+    r->estouros += vencidos - 1;
+    return vencidos;
+}
+
+// Dorme até o prazo e avança
+int ritmo_esperar(Ritmo *r) {
+    struct timespec prazo;
+    ritmo_prazo(r, &prazo);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &prazo, NULL) == EINTR) {
+        // Sinal: voltar a dormir até o mesmo prazo
+    }
+    int vencidos = ritmo_avancar(r);
+    return vencidos > 0 ? vencidos : 1;
+}
+
+// Imprime o atraso dos despertares e os períodos perdidos
+void ritmo_imprimir(FILE *saida, const char *nome, const Ritmo *r) {
+    const Histograma *h = &r->atraso;
+    if (h->total == 0) {
+        fprintf(saida, "Ritmo %s: sem amostras\n", nome);
+        return;
+    }
+    fprintf(saida, "Ritmo %s (%lld ms): n=%lld p50=%.1fus p99=%.1fus max=%.1fus estouros=%lld\n",
+            nome, r->periodo_ns / 1000000LL, h->total,
+            histograma_percentil(h, 50) / 1000.0,
+            histograma_percentil(h, 99) / 1000.0,
+            h->max_ns / 1000.0, r->estouros);
+}
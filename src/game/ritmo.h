@@ -0,0 +1,37 @@
+#ifndef RITMO_H
+#define RITMO_H
+
+#include <stdio.h>
+#include <time.h>
+#include "../estatisticas/estatisticas.h"
+
+// Ritmo de um laço periódico: prazos absolutos no relógio monotônico
+// (prazo anterior + período), então o atraso de um despertar ou o tempo gasto
+// no trabalho não se acumula de um período para o outro
+// Cada Ritmo é usado por uma única thread
+typedef struct {
+    long long periodo_ns;
+    long long prazo_ns;         // próximo prazo (relógio monotônico)
+    long long estouros;         // períodos inteiros perdidos (trabalho ou despertar atrasado demais)
+    Histograma atraso;          // instante do despertar - prazo
+} Ritmo;
+
+// Começa o ritmo agora: o primeiro prazo é daqui a um período
+void ritmo_iniciar(Ritmo *r, long long periodo_ns);
+
+// Prazo atual como timespec do relógio monotônico
+void ritmo_prazo(const Ritmo *r, struct timespec *ts);
+
+// Registra o atraso em relação ao prazo e avança para o próximo prazo futuro
+// Retorna quantos períodos venceram (0 se o prazo ainda não chegou); mais de 1
+// quando o laço atrasou, para quem chama compensar os passos perdidos
+int ritmo_avancar(Ritmo *r);
+
+// Dorme até o prazo com clock_nanosleep(TIMER_ABSTIME) e avança
+// Retorna quantos períodos venceram (pelo menos 1)
+int ritmo_esperar(Ritmo *r);
+
+// Imprime uma linha "Ritmo nome (periodo): n=... p50=... p99=... max=... estouros=..."
+void ritmo_imprimir(FILE *saida, const char *nome, const Ritmo *r);
+
+#endif // RITMO_H
@@ -0,0 +1,679 @@
+#include "simulacao.h"
+#include "pool.h"
+#include "indice.h"
+#include "../fases/fases.h"
+#include "../modulos/modulos.h"
+#include "../estatisticas/estatisticas.h"
+#include "../replay/replay.h"
+#include <string.h>
+
+// Motor de simulação do jogo
+// Contém as regras do mural, dos tedax, do coordenador e do relógio da partida
+// como funções de passo, sem sleeps e sem ncurses. As threads do jogo apenas
+// chamam estes passos no seu próprio ritmo; o modo headless chama simular_tick.
+// Cada passo adquire as travas de que precisa na ordem documentada em game.h.
+
+// Avança o mural um tick (0.2s): gera módulos conforme o intervalo da fase e
+// tira da lista da tela os resolvidos antigos (o retrato só lê a lista)
+void simular_passo_mural(GameState *g) {
+    repor_reserva_modulos(g);
+    
+    trava_travar(&g->trava_modulos);
+    
+    if (g->qtd_modulos < g->max_modulos) {
+        g->ticks_desde_ultimo_modulo++;
+        
+        if (g->ticks_desde_ultimo_modulo >= g->intervalo_geracao) {
+            gerar_novo_modulo(g);
+            g->ticks_desde_ultimo_modulo = 0;
+        }
+    }
+    
+    // Se não há módulos pendentes e ainda não gerou o máximo, gerar imediatamente
+    if (!tem_modulos_pendentes(g) && g->qtd_modulos < g->max_modulos) {
+        gerar_novo_modulo(g);
+    }
+    
+    atualizar_resolvidos_ocultos(g);
+    trava_destravar(&g->trava_modulos);
+}
+
+// Substitui a mensagem de erro exibida na UI (string vazia limpa a mensagem)
+static void definir_mensagem_erro(GameState *g, const char *mensagem) {
+    trava_travar(&g->trava_ui);
+    strncpy(g->mensagem_erro, mensagem, 63);
+    g->mensagem_erro[63] = '\0';
+    trava_destravar(&g->trava_ui);
+}
+
+// Garante que o módulo está em EM_EXECUCAO e com tempo correto
+// Handle velho é ignorado: o passo do tedax libera o tedax depois
+static void garantir_modulo_em_execucao(GameState *g, HandleModulo handle) {
+    trava_travar(&g->trava_modulos);
+    PoolModulos *pool = &g->modulos;
+    int slot = pool_modulos_slot(pool, handle);
+    if (slot < 0) {
+        trava_destravar(&g->trava_modulos);
+        return;
+    }
+    mudar_estado_modulo(g, handle, MOD_EM_EXECUCAO);
+    if (pool->tempo_restante[slot] <= 0) {
+        pool->tempo_restante[slot] = pool->tempo_total[slot];
+    }
+    trava_destravar(&g->trava_modulos);
+}
+
+// Marca a bancada como livre
+// Se alguém estiver registrado na espera, guarda o instante para medir o handoff
+// Retorna o índice do tedax que espera pela bancada (quem deve ser acordado), ou -1
+// NOTA: Não pode ser chamada com trava_modulos travada (ordem das travas)
+static int liberar_bancada(GameState *g, int bancada_idx) {
+    Bancada *b = &g->bancadas[bancada_idx];
+    trava_travar(&b->trava);
+    if (b->estado == BANCADA_OCUPADA) {
+        b->tempo_ocupada_ms += instante_partida_ms(g) - b->ocupada_desde_ms;
+    }
+    b->estado = BANCADA_LIVRE;
+    b->tedax_ocupando = -1;
+    b->liberada_ns = b->tedax_esperando >= 0 ? agora_ns() : 0;
+    int esperando_idx = b->tedax_esperando >= 0 ? b->tedax_esperando - 1 : -1;
+    trava_destravar(&b->trava);
+    return esperando_idx;
+}
+
+// Ocupa a bancada para o tedax se ela estiver livre e não reservada para outro
+// tedax em espera. Se estiver ocupada e ninguém esperar por ela, registra o
+// tedax como esperando (apenas se registrar_espera for 1).
+// Retorna 1 se ocupou, 0 se ficou registrado na espera, -1 caso contrário
+// NOTA: Deve ser chamada com a trava do tedax já travada
+static int ocupar_bancada(GameState *g, Tedax *tedax, int bancada_idx, int registrar_espera) {
+    Bancada *b = &g->bancadas[bancada_idx];
+    int resultado = -1;
+    long long liberada_ns = 0;
+    
+    trava_travar(&b->trava);
+    if (b->estado == BANCADA_LIVRE &&
+        (b->tedax_esperando < 0 || b->tedax_esperando == tedax->id)) {
+        b->estado = BANCADA_OCUPADA;
+        b->ocupada_desde_ms = instante_partida_ms(g);
+        b->tedax_ocupando = tedax->id;
+        b->tedax_esperando = -1;
+        liberada_ns = b->liberada_ns;
+        b->liberada_ns = 0;
+        resultado = 1;
+    } else if (registrar_espera && b->estado == BANCADA_OCUPADA &&
+               (b->tedax_esperando < 0 || b->tedax_esperando == tedax->id)) {
+        b->tedax_esperando = tedax->id;
+        resultado = 0;
+    }
+    trava_destravar(&b->trava);
+    
+    // Tempo entre a bancada ficar livre e o tedax em espera ocupá-la, e entre o
+    // Enter do comando e o tedax finalmente ocupar uma bancada com o módulo dele
+    long long enter_ns = resultado == 1 ? tedax->comando_enter_ns : 0;
+    if (resultado == 1) {
+        tedax->comando_enter_ns = 0;
+    }
+    if (liberada_ns > 0 || enter_ns > 0) {
+        long long agora = agora_ns();
+        trava_travar(&g->trava_modulos);
+        if (liberada_ns > 0) {
+            histograma_registrar(&g->hist_handoff_bancada, agora - liberada_ns);
+        }
+        if (enter_ns > 0) {
+            histograma_registrar(&g->hist_enter_bancada, agora - enter_ns);
+        }
+        trava_destravar(&g->trava_modulos);
+    }
+    
+    return resultado;
+}
+
+// Remove o registro de espera do tedax na bancada (se for ele o registrado)
+// NOTA: Deve ser chamada com a trava do tedax já travada
+static void cancelar_espera_bancada(GameState *g, Tedax *tedax, int bancada_idx) {
+    if (bancada_idx < 0 || bancada_idx >= g->qtd_bancadas) {
+        return;
+    }
+    Bancada *b = &g->bancadas[bancada_idx];
+    trava_travar(&b->trava);
+    if (b->tedax_esperando == tedax->id) {
+        b->tedax_esperando = -1;
+        b->liberada_ns = 0;
+    }
+    trava_destravar(&b->trava);
+}
+
+// Procura a primeira bancada que o tedax consegue ocupar; retorna o índice ou -1
+// NOTA: Deve ser chamada com a trava do tedax já travada
+static int ocupar_bancada_livre(GameState *g, Tedax *tedax) {
+    for (int i = 0; i < g->qtd_bancadas; i++) {
+        if (ocupar_bancada(g, tedax, i, 0) == 1) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Se o tedax está em espera e sua bancada (ou outra) ficou livre, ocupa a bancada
+// Retorna 1 se o tedax saiu da espera
+int simular_verificar_espera_tedax(GameState *g, int tedax_idx) {
+    Tedax *tedax = &g->tedax[tedax_idx];
+    trava_travar(&tedax->trava);
+    
+    if (tedax->estado == TEDAX_ESPERANDO && tedax->bancada_atual >= 0) {
+        int bancada_idx = tedax->bancada_atual;
+        Bancada *b = &g->bancadas[bancada_idx];
+        
+        // Bancada livre e reservada para este tedax (ou para ninguém): ocupar
+        if (ocupar_bancada(g, tedax, bancada_idx, 0) == 1) {
+            mudar_estado_tedax(g, tedax, TEDAX_OCUPADO);
+            garantir_modulo_em_execucao(g, tedax->modulo_atual);
+        } else {
+            trava_travar(&b->trava);
+            int outro_ocupando = b->estado == BANCADA_OCUPADA &&
+                                 b->tedax_ocupando != tedax->id &&
+                                 b->tedax_esperando != tedax->id;
+            trava_destravar(&b->trava);
+            
+            if (outro_ocupando) {
+                // Outro tedax ocupou a bancada e este não está mais na fila: procurar outra bancada
+                int nova_bancada_idx = ocupar_bancada_livre(g, tedax);
+                if (nova_bancada_idx >= 0) {
+                    cancelar_espera_bancada(g, tedax, bancada_idx);
+                    tedax->bancada_atual = nova_bancada_idx;
+                    mudar_estado_tedax(g, tedax, TEDAX_OCUPADO);
+                    garantir_modulo_em_execucao(g, tedax->modulo_atual);
+                } else {
+                    // Nenhuma bancada livre: manter em espera na primeira disponível
+                    // (registrar apenas se não houver outro esperando; tedax que
+                    // esperava sem registro na própria bancada 0 também se registra)
+                    cancelar_espera_bancada(g, tedax, bancada_idx);
+                    int resultado = ocupar_bancada(g, tedax, 0, 1);
+                    if (resultado >= 0) {
+                        tedax->bancada_atual = 0;
+                    }
+                    if (resultado == 1) {
+                        mudar_estado_tedax(g, tedax, TEDAX_OCUPADO);
+                        garantir_modulo_em_execucao(g, tedax->modulo_atual);
+                    }
+                }
+            }
+        }
+    }
+    
+    int saiu_da_espera = tedax->estado != TEDAX_ESPERANDO;
+    trava_destravar(&tedax->trava);
+    return saiu_da_espera;
+}
+
+// Avança um tedax em um segundo: espera por bancada, desarme e fila
+// Retorna o índice do tedax que esperava pela bancada liberada neste passo, ou -1
+int simular_passo_tedax(GameState *g, int tedax_idx) {
+    Tedax *tedax = &g->tedax[tedax_idx];
+    int acordar_idx = -1;
+    
+    // Verificar se este tedax está em espera e a bancada ficou livre
+    simular_verificar_espera_tedax(g, tedax_idx);
+    
+    trava_travar(&tedax->trava);
+    
+    // Verificar se este tedax acabou de sair da espera e precisa começar a processar
+    // Isso garante que módulos atribuídos durante espera sejam processados imediatamente
+    if (tedax->estado != TEDAX_OCUPADO || tedax->modulo_atual == MODULO_NENHUM) {
+        trava_destravar(&tedax->trava);
+        return acordar_idx;
+    }
+    
+    trava_travar(&g->trava_modulos);
+    PoolModulos *pool = &g->modulos;
+    int slot = pool_modulos_slot(pool, tedax->modulo_atual);
+    
+    // Verificação de segurança: não processar módulos já resolvidos
+    // (ou já devolvidos ao pool, quando o handle ficou velho)
+    if (slot < 0 || pool->estado[slot] == MOD_RESOLVIDO) {
+        trava_destravar(&g->trava_modulos);
+        // Módulo já foi resolvido - liberar tedax e bancada
+        if (tedax->bancada_atual >= 0) {
+            acordar_idx = liberar_bancada(g, tedax->bancada_atual);
+        }
+        mudar_estado_tedax(g, tedax, TEDAX_LIVRE);
+        tedax->modulo_atual = MODULO_NENHUM;
+        tedax->bancada_atual = -1;
+        trava_destravar(&tedax->trava);
+        return acordar_idx;
+    }
+    
+    // Verificar se o módulo está realmente em execução
+    // Se não estiver, significa que acabou de ser atribuído e precisa ser iniciado
+    if (pool->estado[slot] != MOD_EM_EXECUCAO) {
+        mudar_estado_modulo(g, tedax->modulo_atual, MOD_EM_EXECUCAO);
+        if (pool->tempo_restante[slot] <= 0) {
+            pool->tempo_restante[slot] = pool->tempo_total[slot];
+        }
+    }
+    
+    // Verificar se o módulo tem instrução digitada (pode ter sido atribuído em espera)
+    // Se não tiver, não processar ainda
+    Modulo *mod = pool_modulos_obter(pool, tedax->modulo_atual);
+    if (mod->instrucao_digitada[0] == '\0') {
+        trava_destravar(&g->trava_modulos);
+        trava_destravar(&tedax->trava);
+        return acordar_idx;
+    }
+    
+    // Decrementar tempo restante
+    pool->tempo_restante[slot]--;
+    if (pool->tempo_restante[slot] > 0) {
+        trava_destravar(&g->trava_modulos);
+        trava_destravar(&tedax->trava);
+        return acordar_idx;
+    }
+    
+    // Quando o tempo acabar, verificar se a instrução estava correta
+    // Comparar instrução digitada com a correta usando validação específica do tipo
+    if (validar_instrucao_modulo(mod, mod->instrucao_digitada)) {
+        // Instrução correta: módulo resolvido
+        mudar_estado_modulo(g, tedax->modulo_atual, MOD_RESOLVIDO);
+        pool->instante_resolvido[slot] = g->tempo_total_partida - g->tempo_restante; // idade conta daqui
+    } else {
+        // Instrução incorreta: módulo volta para o mural
+        mudar_estado_modulo(g, tedax->modulo_atual, MOD_PENDENTE);
+        pool->tempo_restante[slot] = pool->tempo_total[slot]; // Resetar tempo
+        mod->instrucao_digitada[0] = '\0';      // Limpar instrução
+        pool->instante_resolvido[slot] = -1;     // Não resolvido
+        g->erros_cometidos++; // Incrementar contador de erros
+    }
+    trava_destravar(&g->trava_modulos);
+    
+    // Liberar bancada
+    // O tedax registrado na espera tem a reserva dela: ele mesmo a ocupa ao ser
+    // acordado (escalonador) ou na verificação de espera do mesmo tick (simular_tick)
+    if (tedax->bancada_atual >= 0) {
+        acordar_idx = liberar_bancada(g, tedax->bancada_atual);
+    }
+    
+    // Verificar se há módulos na fila deste tedax (máximo 1)
+    HandleModulo proximo_modulo = tedax->qtd_fila > 0 ? tedax->fila_modulos[0] : MODULO_NENHUM;
+    tedax->fila_modulos[0] = MODULO_NENHUM;
+    tedax->qtd_fila = 0;
+    tedax->comando_enter_ns = proximo_modulo != MODULO_NENHUM ? tedax->fila_enter_ns : 0;
+    tedax->fila_enter_ns = 0;
+    
+    // Verificação de segurança: handle velho (módulo já devolvido ao pool) ou
+    // módulo já resolvido não é processado
+    if (proximo_modulo != MODULO_NENHUM) {
+        trava_travar(&g->trava_modulos);
+        int slot_proximo = pool_modulos_slot(&g->modulos, proximo_modulo);
+        if (slot_proximo < 0 || g->modulos.estado[slot_proximo] == MOD_RESOLVIDO) {
+            proximo_modulo = MODULO_NENHUM;
+        }
+        trava_destravar(&g->trava_modulos);
+    }
+    
+    if (proximo_modulo != MODULO_NENHUM) {
+        // Continuar na mesma bancada se ainda estiver livre, senão procurar outra
+        int bancada_idx = -1;
+        if (tedax->bancada_atual >= 0 && ocupar_bancada(g, tedax, tedax->bancada_atual, 0) == 1) {
+            bancada_idx = tedax->bancada_atual;
+        } else {
+            bancada_idx = ocupar_bancada_livre(g, tedax);
+        }
+        
+        if (bancada_idx >= 0 || g->qtd_bancadas > 0) {
+            tedax->modulo_atual = proximo_modulo;
+            if (bancada_idx >= 0) {
+                tedax->bancada_atual = bancada_idx;
+            } else {
+                // Nenhuma bancada livre: entrar em espera na primeira disponível
+                tedax->bancada_atual = 0;
+                if (ocupar_bancada(g, tedax, 0, 1) != 1) {
+                    mudar_estado_tedax(g, tedax, TEDAX_ESPERANDO);
+                }
+            }
+            
+            // Entre as duas travas de módulos o handle pode ter ficado velho;
+            // nesse caso o próximo passo do tedax o libera
+            trava_travar(&g->trava_modulos);
+            int slot_proximo = pool_modulos_slot(&g->modulos, proximo_modulo);
+            if (slot_proximo >= 0) {
+                mudar_estado_modulo(g, proximo_modulo, MOD_EM_EXECUCAO);
+                g->modulos.tempo_restante[slot_proximo] = g->modulos.tempo_total[slot_proximo];
+            }
+            trava_destravar(&g->trava_modulos);
+        } else {
+            proximo_modulo = MODULO_NENHUM; // Sem bancadas: módulo continua pendente
+        }
+    }
+    
+    if (proximo_modulo == MODULO_NENHUM) {
+        // Não há módulos na fila: liberar tedax
+        mudar_estado_tedax(g, tedax, TEDAX_LIVRE);
+        tedax->modulo_atual = MODULO_NENHUM;
+        tedax->bancada_atual = -1;
+    }
+    trava_destravar(&tedax->trava);
+    
+    // Se não há módulos pendentes e ainda não gerou o máximo, gerar um novo imediatamente
+    trava_travar(&g->trava_modulos);
+    if (!tem_modulos_pendentes(g) && g->qtd_modulos < g->max_modulos) {
+        gerar_novo_modulo(g);
+    }
+    trava_destravar(&g->trava_modulos);
+    
+    // Sinalizar que há módulo disponível novamente
+    pthread_cond_broadcast(&g->cond_modulo_disponivel);
+    return acordar_idx;
+}
+
+// Avança o relógio da partida em um segundo e verifica vitória/derrota
+// Retorna 1 se a partida terminou neste passo
+int simular_passo_relogio(GameState *g) {
+    trava_travar(&g->trava_modulos);
+    g->tempo_restante--;
+    
+    // Devolver ao pool os resolvidos que já saíram da tela (uma vez por segundo
+    // de partida, não uma vez por tedax)
+    reciclar_modulos_resolvidos(g);
+    
+    // As idades mudaram: o retrato deste segundo já sai com a lista certa,
+    // mesmo que o próximo passo do mural demore (reator)
+    atualizar_resolvidos_ocultos(g);
+    
+    // Verificar condições de fim de jogo
+    int terminou = (todos_modulos_resolvidos(g) && g->qtd_modulos > 0) || g->tempo_restante <= 0;
+    trava_destravar(&g->trava_modulos);
+    
+    if (terminou) {
+        g->jogo_terminou = 1;
+        g->jogo_rodando = 0;
+    }
+    return terminou;
+}
+
+// Aplica um comando já interpretado (ver simular_aplicar_comando)
+// Travas: tedax -> bancadas (uma por vez) -> módulos
+static int aplicar_comando(GameState *g, const Comando *cmd) {
+    // Limpar mensagem de erro anterior
+    definir_mensagem_erro(g, "");
+    
+    int tedax_idx = cmd->tedax_idx;
+    int bancada_idx = cmd->bancada_idx;
+    HandleModulo modulo = MODULO_NENHUM;
+    const char *instrucao = cmd->instrucao;
+    
+    // Aplicar regras de default para valores não especificados
+    
+    // Se tedax não especificado, pegar APENAS o tedax LIVRE com índice mais baixo
+    // Não pegar tedax em espera para evitar sobrescrever módulos pendentes
+    // O tedax escolhido continua travado até o fim do comando
+    Tedax *t = NULL;
+    if (tedax_idx == -1) {
+        for (int i = 0; i < g->qtd_tedax && !t; i++) {
+            trava_travar(&g->tedax[i].trava);
+            if (g->tedax[i].estado == TEDAX_LIVRE) {
+                tedax_idx = i;
+                t = &g->tedax[i];
+            } else {
+                trava_destravar(&g->tedax[i].trava);
+            }
+        }
+    } else if (tedax_idx < g->qtd_tedax) {
+        t = &g->tedax[tedax_idx];
+        trava_travar(&t->trava);
+    }
+    
+    // Se bancada não especificada, pegar a bancada livre com índice mais baixo
+    // Se não houver livre, pegar a primeira disponível (mesmo que ocupada, para espera)
+    if (bancada_idx == -1) {
+        for (int i = 0; i < g->qtd_bancadas && bancada_idx == -1; i++) {
+            trava_travar(&g->bancadas[i].trava);
+            if (g->bancadas[i].estado == BANCADA_LIVRE) {
+                bancada_idx = i;
+            }
+            trava_destravar(&g->bancadas[i].trava);
+        }
+        // Se não encontrou livre, pegar a primeira (permitir espera)
+        if (bancada_idx == -1 && g->qtd_bancadas > 0) {
+            bancada_idx = 0;
+        }
+    }
+    
+    // Validar recursos
+    // Permitir atribuir módulos a tedax ocupados (será adicionado à fila)
+    // Tedax em espera também pode receber módulos (substitui o anterior)
+    // Não rejeitar bancadas ocupadas - permitir espera
+    int valido = t != NULL && bancada_idx >= 0 && bancada_idx < g->qtd_bancadas &&
+                 strlen(instrucao) > 0;
+    
+    trava_travar(&g->trava_modulos);
+    
+    if (cmd->modulo_id >= 0) {
+        // Procurar módulo pelo ID (módulo já devolvido ao pool não é encontrado)
+        modulo = indice_modulos_buscar(&g->indice_modulos, cmd->modulo_id);
+    } else {
+        // Se módulo não especificado, pegar o primeiro da fila de pendentes
+        modulo = pool_lista_primeiro(&g->modulos, &g->modulos_por_estado[MOD_PENDENTE]);
+    }
+    PoolModulos *pool = &g->modulos;
+    Modulo *mod = pool_modulos_obter(pool, modulo);
+    int slot = pool_modulos_slot(pool, modulo);
+    
+    // Módulo especificado precisa estar pendente (nunca já resolvido)
+    if (!mod || pool->estado[slot] != MOD_PENDENTE) {
+        valido = 0;
+    }
+    
+    if (!valido) {
+        // Recursos não disponíveis ou inválidos
+        trava_destravar(&g->trava_modulos);
+        if (t) {
+            trava_destravar(&t->trava);
+        }
+        definir_mensagem_erro(g, "Entrada Invalida");
+        return 0;
+    }
+    
+    // Designar módulo para o tedax
+    // Verificar se o tedax está ocupado
+    if (t->estado == TEDAX_OCUPADO) {
+        // Tedax ocupado: adicionar módulo à fila
+        
+        // Verificar se já há um módulo na fila (máximo 1)
+        if (t->qtd_fila > 0) {
+            // Já há um módulo na fila - erro
+            trava_destravar(&g->trava_modulos);
+            trava_destravar(&t->trava);
+            definir_mensagem_erro(g, "Tedax ja tem modulo em espera");
+            return 0;
+        }
+        
+        // Copiar instrução
+        strncpy(mod->instrucao_digitada, instrucao, 15);
+        mod->instrucao_digitada[15] = '\0';
+        
+        // Adicionar à fila
+        t->fila_modulos[0] = modulo;
+        t->qtd_fila = 1;
+        t->fila_enter_ns = cmd->enter_ns;
+        // Módulo permanece PENDENTE até ser processado pelo tedax
+        // Não mudar para MOD_EM_EXECUCAO ainda - isso só acontece quando o tedax começar a processá-lo
+        pool->tempo_restante[slot] = pool->tempo_total[slot];
+        
+        trava_destravar(&g->trava_modulos);
+        trava_destravar(&t->trava);
+        return 1;
+    }
+    
+    // Tedax livre ou em espera: atribuir normalmente
+    strncpy(mod->instrucao_digitada, instrucao, 15);
+    mod->instrucao_digitada[15] = '\0';
+    
+    // Se tedax estava esperando, voltar o módulo anterior para PENDENTE se existir
+    int estava_esperando = t->estado == TEDAX_ESPERANDO && t->bancada_atual >= 0;
+    if (estava_esperando) {
+        Modulo *mod_anterior = pool_modulos_obter(pool, t->modulo_atual);
+        int slot_anterior = pool_modulos_slot(pool, t->modulo_atual);
+        if (mod_anterior && pool->estado[slot_anterior] == MOD_EM_EXECUCAO) {
+            mudar_estado_modulo(g, t->modulo_atual, MOD_PENDENTE);
+            pool->tempo_restante[slot_anterior] = pool->tempo_total[slot_anterior];
+            mod_anterior->instrucao_digitada[0] = '\0';
+            pool->instante_resolvido[slot_anterior] = -1;
+        }
+    }
+    
+    // Mudar estado do módulo
+    mudar_estado_modulo(g, modulo, MOD_EM_EXECUCAO);
+    pool->tempo_restante[slot] = pool->tempo_total[slot];
+    trava_destravar(&g->trava_modulos);
+    
+    // Remover da fila de espera da bancada anterior
+    if (estava_esperando) {
+        cancelar_espera_bancada(g, t, t->bancada_atual);
+    }
+    
+    // Bancada livre: ocupar imediatamente; ocupada sem ninguém esperando: registrar espera
+    // (ao ocupar, mede Enter -> bancada; em espera, mede quando for acordado)
+    t->comando_enter_ns = cmd->enter_ns;
+    int resultado = ocupar_bancada(g, t, bancada_idx, 1);
+    int bancada_escolhida = bancada_idx;
+    
+    // Já há outro tedax esperando por esta bancada: procurar outra bancada livre
+    if (resultado < 0) {
+        int livre = ocupar_bancada_livre(g, t);
+        if (livre >= 0) {
+            resultado = 1;
+            bancada_escolhida = livre;
+        }
+    }
+    
+    // Nenhuma bancada livre: entrar em espera na primeira disponível sem fila
+    // (se todas têm alguém esperando, esperar na pedida sem sobrescrever o registro)
+    for (int i = 0; i < g->qtd_bancadas && resultado < 0; i++) {
+        resultado = ocupar_bancada(g, t, i, 1);
+        if (resultado >= 0) {
+            bancada_escolhida = i;
+        }
+    }
+    
+    mudar_estado_tedax(g, t, resultado == 1 ? TEDAX_OCUPADO : TEDAX_ESPERANDO);
+    t->modulo_atual = modulo;
+    t->bancada_atual = bancada_escolhida;
+    trava_destravar(&t->trava);
+    
+    return 1;
+}
+
+// Aplica um comando já interpretado
+// Retorna 1 se o módulo foi designado, 0 se o comando foi rejeitado
+// (neste caso mensagem_erro explica o motivo)
+// Comandos vindos do teclado trazem os instantes da tecla e do Enter: mede a
+// digitação e a espera até a aplicação, e marca o Enter como aplicado depois
+// que o efeito do comando já está no estado (para o quadro que o mostrar)
+int simular_aplicar_comando(GameState *g, const Comando *cmd) {
+    if (cmd->enter_ns > 0) {
+        long long agora = agora_ns();
+        trava_travar(&g->trava_modulos);
+        histograma_registrar(&g->hist_digitacao, cmd->enter_ns - cmd->tecla_ns);
+        histograma_registrar(&g->hist_enter_aplicado, agora - cmd->enter_ns);
+        trava_destravar(&g->trava_modulos);
+    }
+    
+    int designado = aplicar_comando(g, cmd);
+    
+    if (cmd->enter_ns > 0) {
+        trava_travar(&g->trava_modulos);
+        g->ultimo_enter_ns = cmd->enter_ns;
+        trava_destravar(&g->trava_modulos);
+    }
+    return designado;
+}
+
+// Interpreta e aplica na hora um comando no formato T1B1M1:ppp
+// Retorna 1 se o módulo foi designado, 0 se o comando foi rejeitado
+int simular_comando(GameState *g, const char *buffer) {
+    Comando cmd;
+    if (!interpretar_comando(buffer, g->qtd_tedax, g->qtd_bancadas, &cmd)) {
+        definir_mensagem_erro(g, "Entrada Invalida");
+        return 0;
+    }
+    return simular_aplicar_comando(g, &cmd);
+}
+
+// Aplica, em ordem de chegada, todos os comandos que estão em g->comandos
+// Retorna quantos comandos foram aplicados
+// Cada comando é gravado no registro da partida (g->gravacao) antes de aplicado
+// NOTA: Só a thread da simulação (consumidor da fila) pode chamar
+int simular_aplicar_comandos(GameState *g) {
+    Comando cmd;
+    int aplicados = 0;
+    PapelTrava papel = trava_definir_papel(PAPEL_COORDENADOR);
+    while (fila_comandos_receber(&g->comandos, &cmd)) {
+        replay_gravar_comando(g, &cmd);
+        simular_aplicar_comando(g, &cmd);
+        aplicados++;
+    }
+    trava_definir_papel(papel);
+    return aplicados;
+}
+
+// Avança a simulação em dt_ms milissegundos
+// O tempo é acumulado e consumido em ticks de 0.2s (mural); a cada 5 ticks
+// os tedax e o relógio da partida avançam um segundo, na mesma ordem das threads.
+// Comandos enviados desde a última chamada são aplicados antes dos ticks
+// NOTA: Cada passo trava o que precisa; só uma thread deve chamar simular_tick
+void simular_tick(GameState *g, int dt_ms) {
+    simular_aplicar_comandos(g);
+    
+    // Cada passo conta as travas para o papel da thread que o roda no modo com threads
+    PapelTrava papel = trava_definir_papel(PAPEL_MURAL);
+    
+    if (dt_ms > 0) {
+        g->sim_acumulado_ms += dt_ms;
+    }
+    
+    while (g->sim_acumulado_ms >= SIM_TICK_MURAL_MS && !g->jogo_terminou) {
+        g->sim_acumulado_ms -= SIM_TICK_MURAL_MS;
+        
+        trava_definir_papel(PAPEL_MURAL);
+        simular_passo_mural(g);
+        g->sim_ticks++;
+        
+        if (g->sim_ticks % SIM_TICKS_POR_SEGUNDO == 0) {
+            trava_definir_papel(PAPEL_TEDAX);
+            for (int i = 0; i < g->qtd_tedax; i++) {
+                simular_passo_tedax(g, i);
+            }
+            // Tedax em espera ocupam na hora as bancadas liberadas neste segundo
+            // (no modo com threads o escalonador acorda o tedax na hora)
+            for (int i = 0; i < g->qtd_tedax; i++) {
+                simular_verificar_espera_tedax(g, i);
+            }
+            trava_definir_papel(PAPEL_RELOGIO);
+            simular_passo_relogio(g);
+        }
+    }
+    trava_definir_papel(papel);
+}
+
+// Retorna quantos milissegundos faltam até o próximo tick relevante
+// NOTA: Lê a tabela de módulos sem trava; usada apenas pela thread que chama simular_tick
+int simular_ms_ate_proximo_evento(const GameState *g) {
+    // Próximo segundo: relógio da partida e tedax sempre avançam
+    int ticks_ate_segundo = SIM_TICKS_POR_SEGUNDO - (int)(g->sim_ticks % SIM_TICKS_POR_SEGUNDO);
+    int ticks = ticks_ate_segundo;
+    
+    // O mural só muda o estado quando gera um módulo
+    if (g->qtd_modulos < g->max_modulos) {
+        if (!tem_modulos_pendentes(g)) {
+            ticks = 1; // Geração imediata no próximo tick
+        } else {
+            int ticks_ate_geracao = g->intervalo_geracao - g->ticks_desde_ultimo_modulo;
+            if (ticks_ate_geracao < 1) ticks_ate_geracao = 1;
+            if (ticks_ate_geracao < ticks) ticks = ticks_ate_geracao;
+        }
+    }
+    
+    int ms = ticks * SIM_TICK_MURAL_MS - g->sim_acumulado_ms;
+    return ms > 0 ? ms : 0;
+}
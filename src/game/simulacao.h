@@ -0,0 +1,56 @@
+#ifndef SIMULACAO_H
+#define SIMULACAO_H
+
+#include "game.h"
+
+// Duração de um tick do mural em milissegundos (0.2s)
+#define SIM_TICK_MURAL_MS 200
+
+// Quantidade de ticks do mural em um segundo de jogo
+#define SIM_TICKS_POR_SEGUNDO 5
+
+// Motor de simulação: regras do jogo como funções de passo, sem sleeps e sem ncurses
+// Cada função adquire internamente as travas de que precisa (ordem em game.h);
+// não devem ser chamadas com nenhuma trava do jogo já travada
+
+// Avança o mural um tick (0.2s): gera módulos conforme o intervalo da fase e
+// atualiza os resolvidos que saem da lista da tela
+void simular_passo_mural(GameState *g);
+
+// Avança um tedax em um segundo (espera por bancada, desarme e fila de espera)
+// Retorna o índice do tedax registrado na espera da bancada liberada neste
+// passo (quem chama deve rodar simular_verificar_espera_tedax para ele), ou -1
+int simular_passo_tedax(GameState *g, int tedax_idx);
+
+// Se o tedax está em espera e há bancada livre para ele, ocupa a bancada
+// Retorna 1 se o tedax saiu da espera
+int simular_verificar_espera_tedax(GameState *g, int tedax_idx);
+
+// Avança o relógio da partida em um segundo e verifica vitória/derrota
+// Retorna 1 se a partida terminou neste passo
+int simular_passo_relogio(GameState *g);
+
+// Aplica um comando do coordenador já interpretado (ver comandos.h)
+// Retorna 1 se o módulo foi designado, 0 se o comando foi rejeitado
+int simular_aplicar_comando(GameState *g, const Comando *cmd);
+
+// Interpreta e aplica na hora um comando no formato T1B1M1:ppp
+// Retorna 1 se o módulo foi designado, 0 se o comando foi rejeitado
+int simular_comando(GameState *g, const char *buffer);
+
+// Aplica em lote, na ordem de chegada, os comandos enviados para g->comandos
+// Retorna quantos comandos foram aplicados
+// NOTA: Só a thread da simulação (único consumidor da fila) pode chamar
+int simular_aplicar_comandos(GameState *g);
+
+// Avança a simulação em dt_ms milissegundos de jogo, single-threaded
+// Aplica antes os comandos pendentes na fila (fronteira de tick)
+// Permite rodar uma partida inteira sem esperar o tempo real
+void simular_tick(GameState *g, int dt_ms);
+
+// Retorna quantos milissegundos faltam até o próximo tick em que o estado
+// do jogo pode mudar sozinho (relógio, tedax ou geração de módulo)
+// Usada pelo reator para dormir exatamente até o próximo evento
+int simular_ms_ate_proximo_evento(const GameState *g);
+
+#endif // SIMULACAO_H
@@ -0,0 +1,312 @@
+#define _POSIX_C_SOURCE 200809L
+#include "game.h"
+#include "simulacao.h"
+#include "retrato.h"
+#include "../ui/ui.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <ncurses.h>
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS THREADS
+// ============================================================================
+// As regras do jogo ficam no motor de simulação (simulacao.c); cada thread
+// apenas chama o passo correspondente no seu ritmo e cuida de ncurses/sleeps.
+// Depois de cada passo a thread publica um retrato novo da tela (retrato.c).
+// Os tedax não têm thread própria: rodam no escalonador (escalonador.c).
+
+// Buffer de instrução compartilhado (definido em main.c)
+extern char buffer_instrucao_global[64];
+
+// Thread do Mural de Módulos Pendentes
+void* thread_mural(void* arg) {
+    GameState *g = (GameState*)arg;
+    int ticks = 1;
+    trava_definir_papel(PAPEL_MURAL);
+
+    while (g->jogo_rodando && !g->jogo_terminou) {
+        atomic_fetch_add_explicit(&g->despertares, 1, memory_order_relaxed);
+        // Se a thread atrasou, os ticks perdidos são aplicados agora para a
+        // geração de módulos não escorregar em relação ao relógio da partida
+        for (int i = 0; i < ticks; i++) {
+            simular_passo_mural(g);
+        }
+        publicar_retrato_tela(g, buffer_instrucao_global);
+
+        ticks = ritmo_esperar(&g->ritmo_mural); // 0.2 segundos
+    }
+
+    return NULL;
+}
+
+// Dorme até o instante (relógio monotônico) ou até a partida acabar
+static void esperar_proximo_quadro(GameState *g, long long instante_ns) {
+    struct timespec prazo;
+    prazo.tv_sec = instante_ns / 1000000000LL;
+    prazo.tv_nsec = instante_ns % 1000000000LL;
+    trava_travar(&g->trava_quadro);
+    while (g->jogo_rodando && !g->jogo_terminou &&
+           trava_esperar_condicao(&g->trava_quadro, &g->cond_tela_atualizada, &prazo) != ETIMEDOUT) {
+        // Acordada por outra publicação: o quadro continua esperando o prazo
+    }
+    trava_destravar(&g->trava_quadro);
+}
+
+// Repassa ao retrato quantas linhas de módulos o painel comporta agora
+// Se a disposição mudou, o próximo retrato publicado já vem no tamanho novo
+void repassar_linhas_modulos(GameState *g) {
+    int linhas = capacidade_lista_modulos();
+    if (linhas > 0) {
+        atomic_store_explicit(&g->linhas_modulos_tela, linhas, memory_order_relaxed);
+    }
+}
+
+// Thread de Exibição de Informações
+// Desenha o último retrato publicado: não usa nenhuma trava do jogo, então um
+// terminal lento não atrasa tedax nem teclado
+// Não tem período: dorme até alguém publicar um retrato diferente do último
+// (tecla, comando, passo de tedax, segundo do relógio) e desenha na hora, no
+// máximo fps_maximo quadros por segundo; o que for publicado antes do próximo
+// quadro liberado sai num quadro só, com o retrato mais recente
+void* thread_exibicao(void* arg) {
+    GameState *g = (GameState*)arg;
+    trava_definir_papel(PAPEL_EXIBICAO);
+
+    // Inicializar ncurses nesta thread
+    inicializar_ncurses();
+
+    if (has_colors()) {
+        start_color();
+        init_pair(1, COLOR_CYAN, COLOR_BLACK);
+        init_pair(2, COLOR_GREEN, COLOR_BLACK);
+        init_pair(3, COLOR_YELLOW, COLOR_BLACK);
+    }
+
+    long long intervalo_ns = 1000000000LL / g->fps_maximo;
+    long long proximo_quadro_ns = 0;
+
+    while (esperar_retrato_tela(g)) {
+        // Limite de quadros: esperar o intervalo desde o quadro anterior
+        if (agora_ns() < proximo_quadro_ns) {
+            esperar_proximo_quadro(g, proximo_quadro_ns);
+            if (!g->jogo_rodando || g->jogo_terminou) {
+                break;
+            }
+        }
+        atomic_fetch_add_explicit(&g->despertares, 1, memory_order_relaxed);
+
+        // Desenhar tela
+        long long inicio = agora_ns();
+        const RetratoTela *retrato = obter_retrato_tela(g);
+        long bytes = desenhar_tela(retrato);
+        registrar_quadro_desenhado(g, retrato, bytes);
+        repassar_linhas_modulos(g);
+        proximo_quadro_ns = inicio + intervalo_ns;
+    }
+
+    return NULL;
+}
+
+// Próximo valor de um filtro da lista: todos (-1), 0, 1, 2, todos...
+static int proximo_filtro(int filtro) {
+    return filtro >= 2 ? -1 : filtro + 1;
+}
+
+// Teclas da lista de módulos: setas e PgUp/PgDn/Home/End rolam, Tab troca o
+// filtro de estado e Shift+Tab o de tipo (a rolagem volta ao topo)
+// O limite de baixo é o do último retrato; o próximo retrato corrige o resto
+// Retorna 1 se a tecla era da lista
+// NOTA: Deve ser chamada com trava_ui já travada
+static int tratar_tecla_lista(VisaoModulos *v, int ch, int pagina) {
+    switch (ch) {
+        case KEY_UP:
+            v->primeira_linha--;
+            break;
+        case KEY_DOWN:
+            v->primeira_linha++;
+            break;
+        case KEY_PPAGE:
+            v->primeira_linha -= pagina;
+            break;
+        case KEY_NPAGE:
+            v->primeira_linha += pagina;
+            break;
+        case KEY_HOME:
+            v->primeira_linha = 0;
+            break;
+        case KEY_END:
+            v->primeira_linha = v->ultima_primeira_linha;
+            break;
+        case '\t':
+            v->filtro_estado = proximo_filtro(v->filtro_estado);
+            v->primeira_linha = 0;
+            v->ultima_primeira_linha = 0;
+            return 1;
+        case KEY_BTAB:
+            v->filtro_tipo = proximo_filtro(v->filtro_tipo);
+            v->primeira_linha = 0;
+            v->ultima_primeira_linha = 0;
+            return 1;
+        default:
+            return 0;
+    }
+    if (v->primeira_linha > v->ultima_primeira_linha) {
+        v->primeira_linha = v->ultima_primeira_linha;
+    }
+    if (v->primeira_linha < 0) {
+        v->primeira_linha = 0;
+    }
+    return 1;
+}
+
+// Trata uma tecla do coordenador: edita o buffer ou envia o comando no ENTER
+// Retorna 0 se o jogador pediu para sair (tecla 'q'), 1 caso contrário
+// O buffer é editado sob trava_ui; o comando é interpretado fora de qualquer
+// trava e enviado para a fila, que a simulação aplica na fronteira do tick
+int tratar_tecla_coordenador(GameState *g, int ch, char *buffer, int *buffer_len) {
+    if (ch == 'q' || ch == 'Q') {
+        g->jogo_rodando = 0;
+        return 0;
+    }
+
+    char texto[64];
+    texto[0] = '\0';
+    int enviar = 0;
+    long long agora = agora_ns();
+    long long tecla_ns = 0;     // primeira tecla do comando enviado no ENTER
+    
+    int pagina = atomic_load_explicit(&g->linhas_modulos_tela, memory_order_relaxed);
+    
+    trava_travar(&g->trava_ui);
+    g->ultima_tecla_ns = agora;
+    // Rolagem e filtros da lista de módulos
+    if (tratar_tecla_lista(&g->visao_modulos, ch, pagina > 1 ? pagina - 1 : 1)) {
+        // Nada a editar no buffer
+    }
+    // Processar BACKSPACE
+    else if (ch == KEY_BACKSPACE || ch == 127 || ch == '\b') {
+        if (*buffer_len > 0) {
+            (*buffer_len)--;
+            buffer[*buffer_len] = '\0';
+        }
+        if (*buffer_len == 0) {
+            g->tecla_comando_ns = 0; // Comando apagado: o próximo começa do zero
+        }
+    }
+    // Processar ENTER para enviar comando
+    else if (ch == '\n' || ch == '\r') {
+        memcpy(texto, buffer, sizeof(texto));
+        enviar = 1;
+        tecla_ns = g->tecla_comando_ns > 0 ? g->tecla_comando_ns : agora;
+        g->tecla_comando_ns = 0;
+
+        // Limpar buffer
+        *buffer_len = 0;
+        buffer[0] = '\0';
+    }
+    // Aceitar qualquer caractere imprimível
+    else if (ch >= 32 && ch <= 126) {
+        if (*buffer_len < 63) { // Aumentar limite para suportar comandos maiores
+            if (*buffer_len == 0) {
+                g->tecla_comando_ns = agora;
+            }
+            buffer[*buffer_len] = (char)ch;
+            (*buffer_len)++;
+            buffer[*buffer_len] = '\0';
+        }
+    }
+    trava_destravar(&g->trava_ui);
+    
+    if (enviar) {
+        // Comando no formato T1B1M1:ppp (erros vão para mensagem_erro)
+        Comando cmd;
+        const char *erro = NULL;
+        if (!interpretar_comando(texto, g->qtd_tedax, g->qtd_bancadas, &cmd)) {
+            erro = "Entrada Invalida";
+        } else {
+            cmd.tecla_ns = tecla_ns;
+            cmd.enter_ns = agora;
+            if (!fila_comandos_enviar(&g->comandos, &cmd)) {
+                erro = "Muitos comandos pendentes";
+            } else if (!g->modo_reator) {
+                sem_post(&g->sem_comandos); // Acordar a thread da simulação
+            }
+        }
+        
+        if (erro) {
+            trava_travar(&g->trava_ui);
+            strncpy(g->mensagem_erro, erro, 63);
+            g->mensagem_erro[63] = '\0';
+            trava_destravar(&g->trava_ui);
+        }
+    }
+
+    return 1;
+}
+
+// Teclas lidas de uma vez antes de tratá-las
+#define TECLAS_POR_LOTE 64
+
+// Sem pipe de despertar, o coordenador confere o fim da partida neste intervalo
+#define ESPERA_TECLADO_SEM_PIPE_MS 50
+
+// Thread do Coordenador (Jogador)
+// Dorme em poll() sobre o stdin e o pipe de despertar, sem prazo: acorda só
+// quando chega tecla ou quando a partida acaba (a thread principal escreve no
+// pipe). A cada despertar lê todas as teclas pendentes antes de tratar
+// qualquer uma (e de travar qualquer coisa) e publica um retrato por lote
+void* thread_coordenador(void* arg) {
+    GameState *g = (GameState*)arg;
+    int buffer_len = 0;
+    trava_definir_papel(PAPEL_COORDENADOR);
+
+    struct pollfd fds[2];
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+    fds[1].fd = g->pipe_despertar[0]; // fd negativo é ignorado pelo poll
+    fds[1].events = POLLIN;
+    int espera_ms = g->pipe_despertar[0] >= 0 ? -1 : ESPERA_TECLADO_SEM_PIPE_MS;
+    int continuar = 1;
+
+    while (continuar && g->jogo_rodando && !g->jogo_terminou) {
+        if (poll(fds, 2, espera_ms) < 0) {
+            if (errno == EINTR) {
+                continue; // SIGWINCH do ncurses, por exemplo
+            }
+            break;
+        }
+        atomic_fetch_add_explicit(&g->despertares, 1, memory_order_relaxed);
+
+        // Terminal fechado: o stdin ficaria sempre pronto; esperar só o fim da partida
+        if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL)) {
+            fds[0].fd = -1;
+        }
+
+        // Esvaziar o teclado (e o buffer interno do ncurses) em lotes
+        int teclas[TECLAS_POR_LOTE];
+        int qtd;
+        int tratadas = 0;
+        do {
+            qtd = 0;
+            int ch;
+            while (qtd < TECLAS_POR_LOTE && (ch = getch()) != ERR) {
+                teclas[qtd++] = ch;
+            }
+            for (int i = 0; i < qtd && continuar; i++) {
+                continuar = tratar_tecla_coordenador(g, teclas[i], buffer_instrucao_global,
+                                                     &buffer_len);
+            }
+            tratadas += qtd;
+        } while (qtd == TECLAS_POR_LOTE && continuar);
+
+        if (tratadas > 0 && continuar) {
+            publicar_retrato_tela(g, buffer_instrucao_global);
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L
+#include "trava.h"
+#include "../estatisticas/estatisticas.h"
+#include <string.h>
+
+// Papel da thread atual (ver trava_definir_papel)
+static _Thread_local PapelTrava papel_atual = PAPEL_PRINCIPAL;
+
+// Define o papel da thread atual e retorna o anterior
+PapelTrava trava_definir_papel(PapelTrava papel) {
+    PapelTrava anterior = papel_atual;
+    papel_atual = papel;
+    return anterior;
+}
+
+// Nome do papel para os relatórios
+const char* nome_papel_trava(PapelTrava papel) {
+    switch (papel) {
+        case PAPEL_PRINCIPAL:
+            return "principal";
+        case PAPEL_RELOGIO:
+            return "relogio";
+        case PAPEL_MURAL:
+            return "mural";
+        case PAPEL_EXIBICAO:
+            return "exibicao";
+        case PAPEL_TEDAX:
+            return "tedax";
+        case PAPEL_COORDENADOR:
+            return "coordenador";
+        default:
+            return "?";
+    }
+}
+
+// Inicializa a trava com os contadores zerados
+void trava_inicializar(Trava *t) {
+    pthread_mutex_init(&t->mutex, NULL);
+    t->travada_ns = 0;
+    t->papel_dono = PAPEL_PRINCIPAL;
+    t->medindo = 0;
+    memset(t->est, 0, sizeof(t->est));
+}
+
+// Destroi a trava
+void trava_destruir(Trava *t) {
+    pthread_mutex_destroy(&t->mutex);
+}
+
+// Adquire a trava
+// Caminho rápido com trylock: sem contenção o relógio só é lido nas aquisições
+// sorteadas para medir a retenção; a espera só existe (e é medida) no caminho lento
+void trava_travar(Trava *t) {
+    PapelTrava papel = papel_atual;
+    
+    if (pthread_mutex_trylock(&t->mutex) == 0) {
+        EstatTrava *est = &t->est[papel];
+        t->papel_dono = papel;
+        t->medindo = est->aquisicoes % TRAVA_AMOSTRA_RETENCAO == 0;
+        est->aquisicoes++;
+        if (t->medindo) {
+            est->retencoes_medidas++;
+            t->travada_ns = agora_ns();
+        }
+        return;
+    }
+    
+    long long inicio = agora_ns();
+    pthread_mutex_lock(&t->mutex);
+    long long agora = agora_ns();
+    long long espera = agora - inicio;
+    
+    EstatTrava *est = &t->est[papel];
+    est->aquisicoes++;
+    est->contendidas++;
+    est->espera_ns += espera;
+    if (espera > est->espera_max_ns) {
+        est->espera_max_ns = espera;
+    }
+    est->retencoes_medidas++;
+    t->papel_dono = papel;
+    t->medindo = 1;
+    t->travada_ns = agora;
+}
+
+// Conta como retenção do dono o tempo desde travada_ns até agora
+static void contar_retencao(Trava *t, long long agora) {
+    EstatTrava *est = &t->est[t->papel_dono];
+    long long retencao = agora - t->travada_ns;
+    est->retencao_ns += retencao;
+    if (retencao > est->retencao_max_ns) {
+        est->retencao_max_ns = retencao;
+    }
+}
+
+// Libera a trava
+void trava_destravar(Trava *t) {
+    if (t->medindo) {
+        contar_retencao(t, agora_ns());
+    }
+    pthread_mutex_unlock(&t->mutex);
+}
+
+// Espera na condição sem contar o sono como retenção
+// Uma retenção medida continua medida depois de acordar (os trechos antes e
+// depois do sono somam como uma só aquisição)
+int trava_esperar_condicao(Trava *t, pthread_cond_t *cond, const struct timespec *prazo) {
+    PapelTrava papel = t->papel_dono;
+    int medindo = t->medindo;
+    if (medindo) {
+        contar_retencao(t, agora_ns());
+    }
+    int resultado = prazo ? pthread_cond_timedwait(cond, &t->mutex, prazo)
+                          : pthread_cond_wait(cond, &t->mutex);
+    t->papel_dono = papel;
+    t->medindo = medindo;
+    if (medindo) {
+        t->travada_ns = agora_ns();
+    }
+    return resultado;
+}
+
+// Soma os contadores da trava em total, papel a papel
+void trava_somar(EstatTrava total[QTD_PAPEIS_TRAVA], const Trava *t) {
+    for (int p = 0; p < QTD_PAPEIS_TRAVA; p++) {
+        const EstatTrava *est = &t->est[p];
+        total[p].aquisicoes += est->aquisicoes;
+        total[p].contendidas += est->contendidas;
+        total[p].espera_ns += est->espera_ns;
+        total[p].retencao_ns += est->retencao_ns;
+        total[p].retencoes_medidas += est->retencoes_medidas;
+        if (est->espera_max_ns > total[p].espera_max_ns) {
+            total[p].espera_max_ns = est->espera_max_ns;
+        }
+        if (est->retencao_max_ns > total[p].retencao_max_ns) {
+            total[p].retencao_max_ns = est->retencao_max_ns;
+        }
+    }
+}
+
+// Retenção total estimada: média das retenções medidas vezes as aquisições
+static double retencao_estimada_ns(const EstatTrava *est) {
+    if (est->retencoes_medidas == 0) {
+        return 0.0;
+    }
+    return (double)est->retencao_ns * est->aquisicoes / est->retencoes_medidas;
+}
+
+static void imprimir_contadores(FILE *saida, const EstatTrava *est, double retencao_ns) {
+    fprintf(saida, "aquisicoes=%ld contendidas=%ld espera=%.2f ms max=%.1f us "
+            "retencao=%.2f ms max=%.1f us (%ld medidas)\n",
+            est->aquisicoes, est->contendidas, est->espera_ns / 1e6, est->espera_max_ns / 1e3,
+            retencao_ns / 1e6, est->retencao_max_ns / 1e3, est->retencoes_medidas);
+}
+
+// Imprime o total da trava e uma linha por papel que a usou
+void trava_imprimir(FILE *saida, const char *nome, const EstatTrava est[QTD_PAPEIS_TRAVA]) {
+    EstatTrava total;
+    memset(&total, 0, sizeof(total));
+    double retencao_total_ns = 0.0; // soma das estimativas de cada papel
+    int papeis_usados = 0;
+    for (int p = 0; p < QTD_PAPEIS_TRAVA; p++) {
+        total.aquisicoes += est[p].aquisicoes;
+        total.contendidas += est[p].contendidas;
+        total.espera_ns += est[p].espera_ns;
+        total.retencao_ns += est[p].retencao_ns;
+        total.retencoes_medidas += est[p].retencoes_medidas;
+        retencao_total_ns += retencao_estimada_ns(&est[p]);
+        if (est[p].espera_max_ns > total.espera_max_ns) {
+            total.espera_max_ns = est[p].espera_max_ns;
+        }
+        if (est[p].retencao_max_ns > total.retencao_max_ns) {
+            total.retencao_max_ns = est[p].retencao_max_ns;
+        }
+        if (est[p].aquisicoes > 0) {
+            papeis_usados++;
+        }
+    }
+    
+    fprintf(saida, "Trava %s: ", nome);
+    imprimir_contadores(saida, &total, retencao_total_ns);
+    if (papeis_usados < 2) {
+        return; // Um só papel: a linha do total já diz tudo
+    }
+    for (int p = 0; p < QTD_PAPEIS_TRAVA; p++) {
+        if (est[p].aquisicoes > 0) {
+            fprintf(saida, "  %-12s ", nome_papel_trava((PapelTrava)p));
+            imprimir_contadores(saida, &est[p], retencao_estimada_ns(&est[p]));
+        }
+    }
+}
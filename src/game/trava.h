@@ -0,0 +1,78 @@
+#ifndef TRAVA_H
+#define TRAVA_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+// Papel de quem adquire uma trava: cada thread (ou trecho do reator e de
+// simular_tick) declara o seu, e a contabilidade da trava é separada por papel
+typedef enum {
+    PAPEL_PRINCIPAL,            // thread principal fora da partida (inicialização, menus)
+    PAPEL_RELOGIO,              // relógio da partida (thread principal no modo com threads)
+    PAPEL_MURAL,                // geração de módulos
+    PAPEL_EXIBICAO,             // desenho da tela
+    PAPEL_TEDAX,                // passos dos tedax (trabalhadores do escalonador)
+    PAPEL_COORDENADOR,          // teclado e aplicação dos comandos
+    QTD_PAPEIS_TRAVA
+} PapelTrava;
+
+// Contadores de uma trava para um papel (ou a soma de várias travas do mesmo tipo)
+typedef struct {
+    long aquisicoes;            // quantas vezes a trava foi adquirida
+    long contendidas;           // aquisições que encontraram a trava ocupada
+    long long espera_ns;        // tempo total esperando pela trava
+    long long espera_max_ns;    // maior espera individual
+    long long retencao_ns;      // tempo com a trava adquirida, nas aquisições medidas
+    long long retencao_max_ns;  // maior retenção medida
+    long retencoes_medidas;     // aquisições com a retenção medida (ver TRAVA_AMOSTRA_RETENCAO)
+} EstatTrava;
+
+// A retenção de uma aquisição sem contenção é medida em 1 de cada
+// TRAVA_AMOSTRA_RETENCAO (por papel); a de uma aquisição contendida, sempre.
+// O caminho rápido (trylock que pega a trava livre) não lê o relógio nas outras.
+#define TRAVA_AMOSTRA_RETENCAO 16
+
+// Mutex com contabilidade de espera e de retenção, separada por papel
+// Os contadores só são alterados por quem detém a trava, então não precisam ser atômicos
+typedef struct {
+    pthread_mutex_t mutex;
+    long long travada_ns;       // instante em que o dono atual adquiriu a trava (se medindo)
+    PapelTrava papel_dono;      // papel do dono atual
+    int medindo;                // a retenção do dono atual está sendo medida
+    EstatTrava est[QTD_PAPEIS_TRAVA];
+} Trava;
+
+// Define o papel da thread atual (vale para as travas adquiridas daqui em
+// diante) e retorna o anterior, para quem quiser restaurá-lo
+PapelTrava trava_definir_papel(PapelTrava papel);
+
+// Nome do papel para os relatórios
+const char* nome_papel_trava(PapelTrava papel);
+
+// Inicializa a trava com os contadores zerados
+void trava_inicializar(Trava *t);
+
+// Destroi a trava
+void trava_destruir(Trava *t);
+
+// Adquire a trava; se estiver ocupada, mede quanto tempo esperou
+void trava_travar(Trava *t);
+
+// Libera a trava, contando o tempo desde a aquisição como retenção (se medida)
+void trava_destravar(Trava *t);
+
+// pthread_cond_timedwait sobre a trava (já adquirida): o tempo dormindo na
+// condição não conta como retenção; prazo NULL espera sem prazo
+// Retorna o resultado do pthread_cond_*wait (ETIMEDOUT se o prazo venceu)
+int trava_esperar_condicao(Trava *t, pthread_cond_t *cond, const struct timespec *prazo);
+
+// Soma os contadores da trava em total, papel a papel (para agrupar travas por tedax/bancada)
+void trava_somar(EstatTrava total[QTD_PAPEIS_TRAVA], const Trava *t);
+
+// Imprime a linha "Trava nome: aquisicoes=... espera=... retencao=..." com o
+// total e, abaixo dela, uma linha por papel que usou a trava
+// A retenção total é estimada pelas aquisições medidas (média x aquisições)
+void trava_imprimir(FILE *saida, const char *nome, const EstatTrava est[QTD_PAPEIS_TRAVA]);
+
+#endif // TRAVA_H
@@ -4,12 +4,21 @@
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
+#include <errno.h>
+#include <semaphore.h>
 #include <pthread.h>
 #include <ncurses.h>
 #include "../game/game.h"
+#include "../game/simulacao.h"
+#include "../game/retrato.h"
+#include "../game/escalonador.h"
 #include "../ui/ui.h"
 #include "../audio/audio.h"
 #include "../fases/fases.h"
+#include "../reator/reator.h"
+#include "../estatisticas/estatisticas.h"
+#include "../replay/replay.h"
+#include "../telemetria/telemetria.h"
 
 // Buffer de instrução global (compartilhado entre threads)
 // Aumentado para suportar comandos do formato T1B1M1:ppp
@@ -18,11 +27,208 @@ char buffer_instrucao_global[64] = "";
 // Flag global para verificar se áudio está disponível
 int audio_disponivel_global = 0;
 
-int main(void) {
+// Espera um comando do coordenador até o prazo (relógio monotônico)
+// Retorna 1 se chegou comando, 0 se o prazo venceu
+static int esperar_comando_ate(GameState *g, const struct timespec *prazo) {
+    for (;;) {
+        struct timespec agora;
+        clock_gettime(CLOCK_MONOTONIC, &agora);
+        long long restante_ns = (prazo->tv_sec - agora.tv_sec) * 1000000000LL +
+                                (prazo->tv_nsec - agora.tv_nsec);
+        if (restante_ns <= 0) {
+            return sem_trywait(&g->sem_comandos) == 0;
+        }
+        
+        // sem_timedwait usa CLOCK_REALTIME: converter o tempo restante
+        struct timespec limite;
+        clock_gettime(CLOCK_REALTIME, &limite);
+        limite.tv_sec += restante_ns / 1000000000LL;
+        limite.tv_nsec += restante_ns % 1000000000LL;
+        if (limite.tv_nsec >= 1000000000L) {
+            limite.tv_sec++;
+            limite.tv_nsec -= 1000000000L;
+        }
+        
+        if (sem_timedwait(&g->sem_comandos, &limite) == 0) {
+            return 1;
+        }
+        if (errno != EINTR) {
+            return 0;
+        }
+    }
+}
+
+// Roda a partida no modo com threads: mural, exibição, coordenador e os
+// trabalhadores do escalonador dos tedax; a thread principal controla o relógio
+static void executar_com_threads(GameState *g) {
+    // Criar threads
+    pthread_t thread_mural_id;
+    pthread_t thread_exibicao_id;
+    pthread_t thread_coordenador_id;
+    Escalonador escalonador;
+    
+    g->modo_threads = 1;
+    
+    // Pipe que acorda o coordenador (bloqueado em poll) no fim da partida
+    if (pipe(g->pipe_despertar) < 0) {
+        g->pipe_despertar[0] = -1;
+        g->pipe_despertar[1] = -1;
+    }
+    
+    // Primeiro retrato da tela, antes de qualquer thread mexer no estado
+    publicar_retrato_tela(g, buffer_instrucao_global);
+    
+    // Thread do Mural
+    pthread_create(&thread_mural_id, NULL, thread_mural, g);
+    
+    // Thread de Exibição
+    pthread_create(&thread_exibicao_id, NULL, thread_exibicao, g);
+    
+    // Tedax: máquinas de estado num conjunto de trabalhadores (um por núcleo)
+    int escalonador_rodando = escalonador_iniciar(&escalonador, g, 0, buffer_instrucao_global);
+    if (!escalonador_rodando) {
+        g->jogo_rodando = 0; // Sem tedax não há partida
+    }
+    
+    // Thread do Coordenador
+    pthread_create(&thread_coordenador_id, NULL, thread_coordenador, g);
+    
+    // Thread principal: aplica os comandos do coordenador, controla o tempo e
+    // verifica condições de vitória/derrota
+    // O relógio segue prazos absolutos (g->ritmo_relogio): aplicar comandos ou
+    // acordar atrasado não empurra os segundos seguintes
+    Ritmo *relogio = &g->ritmo_relogio;
+    struct timespec prazo;
+    int terminou = 0;
+    PapelTrava papel_anterior = trava_definir_papel(PAPEL_RELOGIO);
+    
+    while (g->jogo_rodando && !g->jogo_terminou && !terminou) {
+        ritmo_prazo(relogio, &prazo);
+        
+        // Cada comando enviado acorda a thread antes do prazo: os comandos são
+        // aplicados em lote, fora do caminho das teclas
+        while (esperar_comando_ate(g, &prazo)) {
+            atomic_fetch_add_explicit(&g->despertares, 1, memory_order_relaxed);
+            if (simular_aplicar_comandos(g) > 0) {
+                publicar_retrato_tela(g, buffer_instrucao_global);
+            }
+        }
+        atomic_fetch_add_explicit(&g->despertares, 1, memory_order_relaxed);
+        
+        // Decrementar tempo e verificar condições de fim de jogo; se a thread
+        // atrasou mais de um segundo, os segundos perdidos contam agora
+        int segundos = ritmo_avancar(relogio);
+        for (int i = 0; i < segundos && !terminou; i++) {
+            terminou = simular_passo_relogio(g);
+        }
+        if (segundos > 0) {
+            publicar_retrato_tela(g, buffer_instrucao_global);
+        }
+    }
+    
+    // Acordar o coordenador, que só acorda sozinho com tecla, e a exibição,
+    // que só acorda com retrato novo
+    if (g->pipe_despertar[1] >= 0) {
+        ssize_t escritos = write(g->pipe_despertar[1], "x", 1);
+        (void)escritos;
+    }
+    avisar_exibicao(g);
+    
+    // Aguardar todas as threads terminarem
+    pthread_join(thread_mural_id, NULL);
+    pthread_join(thread_exibicao_id, NULL);
+    if (escalonador_rodando) {
+        escalonador_parar(&escalonador);
+    }
+    pthread_join(thread_coordenador_id, NULL);
+    trava_definir_papel(papel_anterior);
+    
+    if (g->pipe_despertar[0] >= 0) {
+        close(g->pipe_despertar[0]);
+        close(g->pipe_despertar[1]);
+        g->pipe_despertar[0] = -1;
+        g->pipe_despertar[1] = -1;
+    }
+}
+
+// Refaz as partidas gravadas nos arquivos, sem tela e sem esperar o tempo real
+// Retorna o código de saída: 0 se todas terminaram como gravadas
+static int executar_replays(int qtd_arquivos, char **arquivos) {
+    long long inicio = agora_ns();
+    int partidas = 0;
+    int divergentes = 0;
+    int falhas = 0;
+    for (int i = 0; i < qtd_arquivos; i++) {
+        int total = 0;
+        int resultado = replay_executar_arquivo(arquivos[i], stdout, &total);
+        partidas += total;
+        if (resultado < 0) {
+            falhas++;
+        } else {
+            divergentes += resultado;
+        }
+    }
+    double duracao_ms = (agora_ns() - inicio) / 1e6;
+    printf("%d partidas refeitas em %.1f ms: %d divergiram, %d arquivos com erro\n",
+           partidas, duracao_ms, divergentes, falhas);
+    return divergentes == 0 && falhas == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    // Opções de linha de comando
+    // --reator: roda a partida em um único laço epoll em vez de uma thread por componente
+    // --tedax N / --bancadas N: partida personalizada (até MAX_TEDAX/MAX_BANCADAS)
+    // --semente N: sorteios reproduzíveis (toda partida da sessão usa a semente N)
+    // --gravar ARQ: acrescenta cada partida jogada ao registro ARQ (ver replay.h)
+    // --fps N: no máximo N quadros por segundo na tela (padrão FPS_MAXIMO_PADRAO)
+    // --replay ARQ...: refaz sem tela as partidas gravadas e confere o estado final
+    int modo_reator = 0;
+    int tedax_personalizado = 0;
+    int bancadas_personalizado = 0;
+    uint64_t semente = 0;
+    const char *caminho_gravacao = NULL;
+    int fps_maximo = FPS_MAXIMO_PADRAO;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reator") == 0) {
+            modo_reator = 1;
+        } else if (strcmp(argv[i], "--tedax") == 0 && i + 1 < argc) {
+            tedax_personalizado = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bancadas") == 0 && i + 1 < argc) {
+            bancadas_personalizado = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc) {
+            caminho_gravacao = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps_maximo = atoi(argv[++i]);
+            if (fps_maximo < 1) fps_maximo = 1;
+            if (fps_maximo > FPS_MAXIMO_LIMITE) fps_maximo = FPS_MAXIMO_LIMITE;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            return executar_replays(argc - i - 1, argv + i + 1);
+        } else {
+            fprintf(stderr, "Uso: %s [--reator] [--tedax N] [--bancadas N] [--semente N] "
+                    "[--gravar ARQ] [--fps N]\n       %s --replay ARQ...\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+    
+    // Registro das partidas: aberto em append, cada partida acrescenta a sua
+    FILE *gravacao = NULL;
+    if (caminho_gravacao) {
+        gravacao = fopen(caminho_gravacao, "a");
+        if (!gravacao) {
+            fprintf(stderr, "Nao foi possivel abrir %s para gravar\n", caminho_gravacao);
+            return 1;
+        }
+    }
+    
+
     // Inicializar áudio (mas música começa desligada)
     audio_disponivel_global = inicializar_audio();
     
-    GameState g;
+    // Estático: com o pool e o índice de módulos embutidos, o GameState tem
+    // perto de 1 MB, grande demais para a pilha
+    static GameState g;
     
     while (1) {
         // Inicializar ncurses temporariamente para o menu
@@ -38,6 +244,7 @@ int main(void) {
         int modo_escolhido = mostrar_menu_principal();
         if (modo_escolhido == -1) {
             finalizar_ncurses();
+            if (gravacao) fclose(gravacao);
             printf("Jogo encerrado.\n");
             return 0;
         }
@@ -69,8 +276,8 @@ int main(void) {
     
             // Obter configuração da fase para número de tedax e bancadas
             const ConfigFase *config = obter_config_fase(dificuldade_escolhida);
-            int num_tedax = config->num_tedax;
-            int num_bancadas = config->num_bancadas;
+            int num_tedax = tedax_personalizado > 0 ? tedax_personalizado : config->num_tedax;
+            int num_bancadas = bancadas_personalizado > 0 ? bancadas_personalizado : config->num_bancadas;
             
             // Finalizar ncurses temporário (será reinicializado nas threads)
             finalizar_ncurses();
@@ -100,101 +307,43 @@ int main(void) {
             }
             
             // Inicializar jogo com a dificuldade escolhida
-            inicializar_jogo(&g, dificuldade_escolhida, num_tedax, num_bancadas);
-    
-    // Criar threads
-    pthread_t thread_mural_id;
-    pthread_t thread_exibicao_id;
-    pthread_t thread_tedax_ids[5];
-    pthread_t thread_coordenador_id;
-    
-    // Thread do Mural
-    pthread_create(&thread_mural_id, NULL, thread_mural, &g);
-    
-    // Thread de Exibição
-    pthread_create(&thread_exibicao_id, NULL, thread_exibicao, &g);
-    
-    // Threads dos Tedax (até 5)
-    for (int i = 0; i < g.qtd_tedax; i++) {
-        typedef struct {
-            GameState *g;
-            int tedax_id;
-        } TedaxArgs;
-        
-        TedaxArgs *args = malloc(sizeof(TedaxArgs));
-        args->g = &g;
-        args->tedax_id = i;
-        pthread_create(&thread_tedax_ids[i], NULL, thread_tedax, args);
-    }
-    
-    // Thread do Coordenador
-    pthread_create(&thread_coordenador_id, NULL, thread_coordenador, &g);
-    
-    // Thread principal: controla o tempo e verifica condições de vitória/derrota
-    int tick_count = 0;
-    struct timespec ts;
-    ts.tv_sec = 0;
-    ts.tv_nsec = 200000000L; // 0.2 segundos
-    
-    while (g.jogo_rodando && !g.jogo_terminou) {
-        nanosleep(&ts, NULL);
-        
-        tick_count++;
-        if (tick_count >= 5) { // 1 segundo
-            pthread_mutex_lock(&g.mutex_jogo);
-            
-            g.tempo_restante--;
-            
-            // Verificar condições de fim de jogo
-            if (todos_modulos_resolvidos(&g) && g.qtd_modulos > 0) {
-                g.jogo_terminou = 1;
-                g.jogo_rodando = 0;
-                pthread_mutex_unlock(&g.mutex_jogo);
-                break;
-            }
-            
-            if (g.tempo_restante <= 0) {
-                g.jogo_terminou = 1;
-                g.jogo_rodando = 0;
-                pthread_mutex_unlock(&g.mutex_jogo);
-                break;
+            inicializar_jogo(&g, dificuldade_escolhida, num_tedax, num_bancadas, semente);
+            g.fps_maximo = fps_maximo;
+            if (gravacao) {
+                replay_gravar_inicio(&g, gravacao);
             }
-            
-            pthread_mutex_unlock(&g.mutex_jogo);
-            tick_count = 0;
-        }
-    }
     
-    // Aguardar todas as threads terminarem
-    pthread_join(thread_mural_id, NULL);
-    pthread_join(thread_exibicao_id, NULL);
-    for (int i = 0; i < g.qtd_tedax; i++) {
-        pthread_join(thread_tedax_ids[i], NULL);
-    }
-    pthread_join(thread_coordenador_id, NULL);
+            // Rodar a partida: reator epoll (--reator) ou uma thread por componente
+            if (!modo_reator || !executar_reator(&g)) {
+                executar_com_threads(&g);
+            }
+            g.fim_ns = agora_ns();
+            replay_gravar_fim(&g);
     
     // Ncurses ainda está ativo (não foi finalizado pela thread de exibição)
     // Limpar a tela antes de mostrar o menu pós-jogo
     clear();
     refresh();
     
-            pthread_mutex_lock(&g.mutex_jogo);
+            trava_travar(&g.trava_modulos);
             int vitoria = 0;
             int tempo_restante_final = g.tempo_restante;
             int erros_final = g.erros_cometidos;
+            int qtd_modulos_final = g.qtd_modulos;
             if (todos_modulos_resolvidos(&g) && g.qtd_modulos > 0) {
                 vitoria = 1;
-            } else if (g.qtd_modulos > 0) {
-                vitoria = 0;
-            } else {
+            }
+            trava_destravar(&g.trava_modulos);
+            
+            if (qtd_modulos_final == 0) {
                 clear();
                 mvprintw(LINES / 2, COLS / 2 - 15, "Tempo esgotado - Nenhum modulo gerado");
                 refresh();
                 sleep(2);
                 finalizar_ncurses();
+                finalizar_jogo(&g);
                 continue;
             }
-            pthread_mutex_unlock(&g.mutex_jogo);
             
             // Parar música da fase e tocar música de vitória/derrota
             parar_musica();
@@ -226,7 +375,19 @@ int main(void) {
             
             finalizar_ncurses();
             
+            // Relatório da partida (stderr ou arquivo em $TEDAX_STATS)
+            FILE *saida_stats = abrir_saida_estatisticas();
+            imprimir_estatisticas_partida(&g, saida_stats);
+            fechar_saida_estatisticas(saida_stats);
+            
+            // Registro de telemetria da partida ($TEDAX_TELEMETRIA, JSON ou CSV)
+            telemetria_registrar_partida(&g);
+            
+            // Liberar o pool de módulos e as travas antes da próxima partida
+            finalizar_jogo(&g);
+            
             if (opcao == 'q' || opcao == 'Q') {
+                if (gravacao) fclose(gravacao);
                 printf("Jogo encerrado.\n");
                 return 0;
             } else if (opcao == 'r' || opcao == 'R') {
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <pthread.h>
 
 // Mapeamento de letras A-I para números usando matrizes 3x3
 // Matriz de letras (sempre a mesma):
@@ -14,24 +15,27 @@
 // 9 | 5 | 2
 // 6 | 8 | 1
 // 7 | 3 | 4
-static const char mapeamento_hash[9] = {
-    '9', '5', '2',  // A, B, C
-    '6', '8', '1',  // D, E, F
-    '7', '3', '4'   // G, H, I
+// Tradução letra do hash -> dígito da senha, indexada pelo byte (0 = não é
+// letra do hash): uma consulta por caractere, sem montar strings temporárias
+static const char traducao_hash[256] = {
+    ['A'] = '9', ['B'] = '5', ['C'] = '2',
+    ['D'] = '6', ['E'] = '8', ['F'] = '1',
+    ['G'] = '7', ['H'] = '3', ['I'] = '4'
 };
 
 // Gera uma sequência aleatória de letras A-I com tamanho baseado na dificuldade
-static void gerar_sequencia_senha(char *buffer, int tamanho_max, Dificuldade dificuldade) {
+static void gerar_sequencia_senha(char *buffer, int tamanho_max, Dificuldade dificuldade,
+                                  Aleatorio *aleatorio) {
     int tamanho;
     switch (dificuldade) {
         case DIFICULDADE_FACIL:
-            tamanho = 4 + (rand() % 2); // 3 ou 4 caracteres
+            tamanho = 4 + aleatorio_abaixo(aleatorio, 2); // 3 ou 4 caracteres
             break;
         case DIFICULDADE_MEDIO:
-            tamanho = 6 + (rand() % 2); // 4 ou 5 caracteres
+            tamanho = 6 + aleatorio_abaixo(aleatorio, 2); // 4 ou 5 caracteres
             break;
         case DIFICULDADE_DIFICIL:
-            tamanho = 8 + (rand() % 2); // 5 ou 6 caracteres
+            tamanho = 8 + aleatorio_abaixo(aleatorio, 2); // 5 ou 6 caracteres
             break;
         default:
             tamanho = 4; // Padrão
@@ -45,7 +49,7 @@ static void gerar_sequencia_senha(char *buffer, int tamanho_max, Dificuldade dif
     
     // Gerar sequência aleatória usando apenas A-I
     for (int i = 0; i < tamanho; i++) {
-        buffer[i] = 'A' + (rand() % 9); // A até I (0-8)
+        buffer[i] = 'A' + aleatorio_abaixo(aleatorio, 9); // A até I (0-8)
     }
     buffer[tamanho] = '\0';
 }
@@ -55,12 +59,12 @@ static const char* cores_fios[] = {"R", "G", "B", "Y", "W", "K"}; // Vermelho, V
 
 
 // Gera um módulo de botão
-void gerar_modulo_botao(Modulo *mod, Dificuldade dificuldade) {
+void gerar_modulo_botao(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio) {
     (void)dificuldade; // Parâmetro não usado, mas mantido para consistência
     mod->tipo = TIPO_BOTAO;
     
     // Sortear cor (0 = Vermelho, 1 = Verde, 2 = Azul)
-    int cor_aleatoria = rand() % 3;
+    int cor_aleatoria = aleatorio_abaixo(aleatorio, 3);
     mod->dados.botao.cor = (CorBotao)cor_aleatoria;
     
     // Definir instrução correta baseada na cor
@@ -78,32 +82,27 @@ void gerar_modulo_botao(Modulo *mod, Dificuldade dificuldade) {
 }
 
 // Gera um módulo de senha
-void gerar_modulo_senha(Modulo *mod, Dificuldade dificuldade) {
+void gerar_modulo_senha(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio) {
     mod->tipo = TIPO_SENHA;
     
     // Gerar sequência aleatória de letras A-I com tamanho baseado na dificuldade
-    gerar_sequencia_senha(mod->dados.senha.hash, 32, dificuldade);
+    gerar_sequencia_senha(mod->dados.senha.hash, 32, dificuldade, aleatorio);
     
-    // Gerar senha numérica baseada no mapeamento
-    const char* mapeamento = mapeamento_hash;
-    int len = strlen(mod->dados.senha.hash);
-    mod->dados.senha.senha_correta[0] = '\0';
-    
-    for (int i = 0; i < len; i++) {
-        char c = mod->dados.senha.hash[i];
-        if (c >= 'A' && c <= 'I') {
-            char num = mapeamento[c - 'A'];
-            char num_str[2] = {num, '\0'};
-            strcat(mod->dados.senha.senha_correta, num_str);
+    // Gerar senha numérica baseada no mapeamento (um dígito por letra, direto
+    // no destino)
+    const char *hash = mod->dados.senha.hash;
+    char *senha = mod->dados.senha.senha_correta;
+    int len = 0;
+    for (int i = 0; hash[i] != '\0'; i++) {
+        char digito = traducao_hash[(unsigned char)hash[i]];
+        if (digito) {
+            senha[len++] = digito;
         }
     }
-    
-    // Armazenar índice de dificuldade para validação
-    mod->dados.senha.mapeamento[0] = (char)dificuldade;
-    mod->dados.senha.mapeamento[1] = '\0';
+    senha[len] = '\0';
     
     // A instrução correta é a senha numérica
-    strcpy(mod->instrucao_correta, mod->dados.senha.senha_correta);
+    memcpy(mod->instrucao_correta, senha, len + 1);
 }
 
 // Padrões de regras para módulo de fios
@@ -112,29 +111,26 @@ void gerar_modulo_senha(Modulo *mod, Dificuldade dificuldade) {
 // Padrão 2: Cortar o segundo fio se não houver fio preto
 // Padrão 3: Cortar o fio de cor que aparece mais vezes
 // Padrão 4: Cortar o fio na posição do número de fios dividido por 2 (arredondado)
+//
+// Com 5 fios de 6 cores só existem 6^5 sequências, então a resposta de cada
+// par (padrão, sequência) é calculada uma vez, na primeira vez que um módulo de
+// fios é gerado ou validado, e depois gerar e validar é uma consulta à tabela
 
-static void aplicar_padrao_fios(Modulo *mod) {
-    char sequencia[32];
-    strcpy(sequencia, mod->dados.fios.sequencia);
-    
-    // Contar fios (separados por /)
-    int num_fios = 0;
-    char* token = strtok(sequencia, "/");
-    char cores[10][4];
-    while (token != NULL && num_fios < 10) {
-        strcpy(cores[num_fios], token);
-        num_fios++;
-        token = strtok(NULL, "/");
-    }
-    
-    int padrao = mod->dados.fios.padrao;
+#define FIOS_CORES 6
+#define FIOS_SEQUENCIAS 7776 // FIOS_CORES ^ FIOS_POR_MODULO
+
+static unsigned char respostas_fios[FIOS_PADROES][FIOS_SEQUENCIAS];
+static pthread_once_t respostas_fios_prontas = PTHREAD_ONCE_INIT;
+
+// Posição do fio a cortar (1 a num_fios) pelas regras do padrão
+static int calcular_resposta_fios(int padrao, const int *cores, int num_fios) {
     int posicao_cortar = -1;
     
     switch (padrao) {
         case 0: {
             // Cortar o primeiro fio de cor primária (R, G, B)
             for (int i = 0; i < num_fios; i++) {
-                if (strcmp(cores[i], "R") == 0 || strcmp(cores[i], "G") == 0 || strcmp(cores[i], "B") == 0) {
+                if (cores[i] == COR_FIO_VERMELHO || cores[i] == COR_FIO_VERDE || cores[i] == COR_FIO_AZUL) {
                     posicao_cortar = i + 1; // +1 porque posições começam em 1
                     break;
                 }
@@ -146,7 +142,7 @@ static void aplicar_padrao_fios(Modulo *mod) {
             // Cortar o último fio se houver fio amarelo
             int tem_amarelo = 0;
             for (int i = 0; i < num_fios; i++) {
-                if (strcmp(cores[i], "Y") == 0) {
+                if (cores[i] == COR_FIO_AMARELO) {
                     tem_amarelo = 1;
                     break;
                 }
@@ -158,7 +154,7 @@ static void aplicar_padrao_fios(Modulo *mod) {
             // Cortar o segundo fio se não houver fio preto
             int tem_preto = 0;
             for (int i = 0; i < num_fios; i++) {
-                if (strcmp(cores[i], "K") == 0) {
+                if (cores[i] == COR_FIO_PRETO) {
                     tem_preto = 1;
                     break;
                 }
@@ -167,28 +163,23 @@ static void aplicar_padrao_fios(Modulo *mod) {
             break;
         }
         case 3: {
-            // Cortar o fio de cor que aparece mais vezes
-            int contadores[6] = {0}; // R, G, B, Y, W, K
+            // Cortar o fio de cor que aparece mais vezes (empate: a cor que vem
+            // antes em R, G, B, Y, W, K)
+            int contadores[FIOS_CORES] = {0};
             for (int i = 0; i < num_fios; i++) {
-                if (strcmp(cores[i], "R") == 0) contadores[0]++;
-                else if (strcmp(cores[i], "G") == 0) contadores[1]++;
-                else if (strcmp(cores[i], "B") == 0) contadores[2]++;
-                else if (strcmp(cores[i], "Y") == 0) contadores[3]++;
-                else if (strcmp(cores[i], "W") == 0) contadores[4]++;
-                else if (strcmp(cores[i], "K") == 0) contadores[5]++;
+                contadores[cores[i]]++;
             }
             
             int max_idx = 0;
-            for (int i = 1; i < 6; i++) {
+            for (int i = 1; i < FIOS_CORES; i++) {
                 if (contadores[i] > contadores[max_idx]) {
                     max_idx = i;
                 }
             }
             
             // Encontrar primeira posição da cor mais frequente
-            const char* cor_alvo = cores_fios[max_idx];
             for (int i = 0; i < num_fios; i++) {
-                if (strcmp(cores[i], cor_alvo) == 0) {
+                if (cores[i] == max_idx) {
                     posicao_cortar = i + 1;
                     break;
                 }
@@ -203,31 +194,106 @@ static void aplicar_padrao_fios(Modulo *mod) {
         }
     }
     
-    // Converter posição para string
-    sprintf(mod->instrucao_correta, "%d", posicao_cortar);
+    return posicao_cortar;
+}
+
+// Preenche a tabela de respostas (roda uma única vez)
+// A sequência de índice s tem o fio i na cor (s / 6^i) % 6
+static void preparar_respostas_fios(void) {
+    for (int sequencia = 0; sequencia < FIOS_SEQUENCIAS; sequencia++) {
+        int cores[FIOS_POR_MODULO];
+        int resto = sequencia;
+        for (int i = 0; i < FIOS_POR_MODULO; i++) {
+            cores[i] = resto % FIOS_CORES;
+            resto /= FIOS_CORES;
+        }
+        for (int padrao = 0; padrao < FIOS_PADROES; padrao++) {
+            respostas_fios[padrao][sequencia] =
+                (unsigned char)calcular_resposta_fios(padrao, cores, FIOS_POR_MODULO);
+        }
+    }
+}
+
+// Posição do fio a cortar (1-5) para o padrão e as cores empacotadas
+int resposta_fios(int padrao, uint16_t cores) {
+    pthread_once(&respostas_fios_prontas, preparar_respostas_fios);
+    
+    // Cores empacotadas em 3 bits por fio -> índice da sequência na base 6
+    int sequencia = 0;
+    for (int i = FIOS_POR_MODULO - 1; i >= 0; i--) {
+        sequencia = sequencia * FIOS_CORES + ((cores >> (3 * i)) & 7);
+    }
+    return respostas_fios[padrao][sequencia];
 }
 
 // Gera um módulo de fios
-void gerar_modulo_fios(Modulo *mod, Dificuldade dificuldade) {
+void gerar_modulo_fios(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio) {
     (void)dificuldade; // Parâmetro não usado, mas mantido para consistência
     mod->tipo = TIPO_FIOS;
     
     // Escolher padrão aleatório (0-4)
-    mod->dados.fios.padrao = rand() % 5;
+    mod->dados.fios.padrao = aleatorio_abaixo(aleatorio, FIOS_PADROES);
     
-    // Gerar sequência de fios (5 fios)
-    int num_fios = 5;
-    mod->dados.fios.sequencia[0] = '\0';
+    // Gerar sequência de fios (5 fios, 6 cores cada): um sorteio para a
+    // sequência inteira, desempacotado em códigos de 3 bits e no texto da tela
+    int sequencia = aleatorio_abaixo(aleatorio, FIOS_SEQUENCIAS);
+    uint16_t cores = 0;
+    char *texto = mod->dados.fios.sequencia;
+    *texto++ = '/';
+    for (int i = 0; i < FIOS_POR_MODULO; i++) {
+        int cor = sequencia % FIOS_CORES;
+        sequencia /= FIOS_CORES;
+        cores |= (uint16_t)(cor << (3 * i));
+        *texto++ = cores_fios[cor][0];
+        *texto++ = '/';
+    }
+    *texto = '\0';
+    mod->dados.fios.cores = cores;
     
-    for (int i = 0; i < num_fios; i++) {
-        int cor_idx = rand() % 6; // 6 cores disponíveis
-        strcat(mod->dados.fios.sequencia, "/");
-        strcat(mod->dados.fios.sequencia, cores_fios[cor_idx]);
+    // Instrução correta: posição do fio a cortar, consultada na tabela
+    int posicao = resposta_fios(mod->dados.fios.padrao, cores);
+    mod->instrucao_correta[0] = (char)('0' + posicao);
+    mod->instrucao_correta[1] = '\0';
+}
+
+// Gera um módulo de tipo sorteado com os pesos da dificuldade
+// fácil: 40% fios, 40% botão, 20% hash
+// médio: 40% fios, 30% botão, 30% hash
+// difícil: 40% fios, 20% botão, 40% hash
+void gerar_modulo_aleatorio(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio) {
+    int limite_botao;
+    switch (dificuldade) {
+        case DIFICULDADE_FACIL:
+            limite_botao = 80;
+            break;
+        case DIFICULDADE_MEDIO:
+            limite_botao = 70;
+            break;
+        case DIFICULDADE_DIFICIL:
+            limite_botao = 60;
+            break;
+        default:
+            gerar_modulo_botao(mod, dificuldade, aleatorio);
+            mod->instrucao_digitada[0] = '\0';
+            return;
     }
-    strcat(mod->dados.fios.sequencia, "/");
     
-    // Aplicar padrão para determinar instrução correta
-    aplicar_padrao_fios(mod);
+    int tipo_aleatorio = aleatorio_abaixo(aleatorio, 100);
+    if (tipo_aleatorio < 40) {
+        gerar_modulo_fios(mod, dificuldade, aleatorio);
+    } else if (tipo_aleatorio < limite_botao) {
+        gerar_modulo_botao(mod, dificuldade, aleatorio);
+    } else {
+        gerar_modulo_senha(mod, dificuldade, aleatorio);
+    }
+    mod->instrucao_digitada[0] = '\0';
+}
+
+// Gera n módulos de tipos sorteados em mods[0..n-1]
+void gerar_lote_modulos(Modulo *mods, int n, Dificuldade dificuldade, Aleatorio *aleatorio) {
+    for (int i = 0; i < n; i++) {
+        gerar_modulo_aleatorio(&mods[i], dificuldade, aleatorio);
+    }
 }
 
 // Valida instrução para módulo de botão
@@ -240,9 +306,10 @@ int validar_instrucao_senha(const Modulo *mod, const char *instrucao) {
     return strcmp(instrucao, mod->instrucao_correta) == 0;
 }
 
-// Valida instrução para módulo de fios
+// Valida instrução para módulo de fios (a resposta vem da tabela)
 int validar_instrucao_fios(const Modulo *mod, const char *instrucao) {
-    return strcmp(instrucao, mod->instrucao_correta) == 0;
+    int posicao = resposta_fios(mod->dados.fios.padrao, mod->dados.fios.cores);
+    return instrucao[0] == '0' + posicao && instrucao[1] == '\0';
 }
 
 // Função genérica para validar instrução
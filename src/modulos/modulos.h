@@ -4,9 +4,19 @@
 #include "../game/game.h"
 
 // Funções para gerar módulos de cada tipo
-void gerar_modulo_botao(Modulo *mod, Dificuldade dificuldade);
-void gerar_modulo_senha(Modulo *mod, Dificuldade dificuldade);
-void gerar_modulo_fios(Modulo *mod, Dificuldade dificuldade);
+// Todo sorteio sai do fluxo aleatorio (ver aleatorio.h): a mesma semente gera
+// os mesmos módulos
+void gerar_modulo_botao(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio);
+void gerar_modulo_senha(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio);
+void gerar_modulo_fios(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio);
+
+// Gera um módulo de tipo sorteado com os pesos da dificuldade (enigma,
+// instrução correta e instrução digitada vazia; id e cronômetros ficam com o jogo)
+void gerar_modulo_aleatorio(Modulo *mod, Dificuldade dificuldade, Aleatorio *aleatorio);
+
+// Gera n módulos de tipos sorteados em mods[0..n-1]
+// Não usa estado do jogo: pode rodar fora de qualquer trava
+void gerar_lote_modulos(Modulo *mods, int n, Dificuldade dificuldade, Aleatorio *aleatorio);
 
 // Funções para validar instruções de cada tipo
 int validar_instrucao_botao(const Modulo *mod, const char *instrucao);
@@ -0,0 +1,186 @@
+#define _GNU_SOURCE
+#include "reator.h"
+#include "../game/simulacao.h"
+#include "../game/retrato.h"
+#include "../ui/ui.h"
+#include "../estatisticas/estatisticas.h"
+#include <ncurses.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+// Buffer de instrução compartilhado (definido em main.c)
+extern char buffer_instrucao_global[64];
+
+// Arma o timerfd para disparar uma única vez daqui a ms milissegundos
+static void armar_timer(int timer_fd, int ms) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (ms < 1) ms = 1; // it_value zerado desarmaria o timer
+    its.it_value.tv_sec = ms / 1000;
+    its.it_value.tv_nsec = (long)(ms % 1000) * 1000000L;
+    timerfd_settime(timer_fd, 0, &its, NULL);
+}
+
+// Registra fd no epoll para leitura
+static int observar_fd(int epoll_fd, int fd) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+// Executa a partida no modo reator
+// Retorna 1 se a partida rodou no reator, 0 se não foi possível montar o
+// epoll/timerfd/signalfd (o chamador deve usar o modo com threads)
+int executar_reator(GameState *g) {
+    // Sinais tratados como eventos do laço, não como handlers assíncronos
+    sigset_t sinais, sinais_anteriores;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGWINCH);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    sigprocmask(SIG_BLOCK, &sinais, &sinais_anteriores);
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    int sinal_fd = signalfd(-1, &sinais, SFD_CLOEXEC);
+
+    if (epoll_fd < 0 || timer_fd < 0 || sinal_fd < 0 ||
+        observar_fd(epoll_fd, STDIN_FILENO) < 0 ||
+        observar_fd(epoll_fd, timer_fd) < 0 ||
+        observar_fd(epoll_fd, sinal_fd) < 0) {
+        if (epoll_fd >= 0) close(epoll_fd);
+        if (timer_fd >= 0) close(timer_fd);
+        if (sinal_fd >= 0) close(sinal_fd);
+        sigprocmask(SIG_SETMASK, &sinais_anteriores, NULL);
+        return 0;
+    }
+
+    g->modo_reator = 1;
+
+    // Inicializar ncurses (no modo com threads isso é feito pela thread de exibição)
+    inicializar_ncurses();
+    if (has_colors()) {
+        start_color();
+        init_pair(1, COLOR_CYAN, COLOR_BLACK);
+        init_pair(2, COLOR_GREEN, COLOR_BLACK);
+        init_pair(3, COLOR_YELLOW, COLOR_BLACK);
+    }
+
+    int buffer_len = (int)strlen(buffer_instrucao_global);
+    long long inicio_ns = agora_ns();
+    long long ms_simulados = 0;
+
+    // A tela só é desenhada quando o retrato muda (ou o terminal muda de
+    // tamanho), no máximo fps_maximo vezes por segundo: um quadro adiado
+    // encurta o timer até o instante em que ele é liberado
+    long long intervalo_quadro_ns = 1000000000LL / g->fps_maximo;
+    int redesenhar = 0;         // terminal redimensionado: desenhar mesmo sem retrato novo
+
+    publicar_retrato_tela(g, buffer_instrucao_global);
+    const RetratoTela *primeiro = obter_retrato_tela(g);
+    registrar_quadro_desenhado(g, primeiro, desenhar_tela(primeiro));
+    repassar_linhas_modulos(g);
+    long long proximo_quadro_ns = agora_ns() + intervalo_quadro_ns;
+    armar_timer(timer_fd, simular_ms_ate_proximo_evento(g));
+
+    while (g->jogo_rodando && !g->jogo_terminou) {
+        struct epoll_event eventos[4];
+        int n = epoll_wait(epoll_fd, eventos, 4, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        atomic_fetch_add_explicit(&g->despertares, 1, memory_order_relaxed);
+
+        for (int i = 0; i < n; i++) {
+            int fd = eventos[i].data.fd;
+
+            if (fd == timer_fd) {
+                uint64_t expiracoes;
+                if (read(timer_fd, &expiracoes, sizeof(expiracoes)) < 0) {
+                    // Nada a fazer: o tempo decorrido é medido abaixo
+                }
+            } else if (fd == sinal_fd) {
+                struct signalfd_siginfo info;
+                if (read(sinal_fd, &info, sizeof(info)) == sizeof(info)) {
+                    if (info.ssi_signo == SIGWINCH) {
+                        // Terminal redimensionado: ncurses relê o tamanho no próximo refresh
+                        endwin();
+                        refresh();
+                        invalidar_tela();
+                        redesenhar = 1;
+                    } else {
+                        g->jogo_rodando = 0; // SIGINT/SIGTERM: encerrar a partida
+                    }
+                }
+            } else if (fd == STDIN_FILENO) {
+                // Consumir todas as teclas disponíveis de uma vez
+                // (as travas contam para o papel de cada trecho, como no modo com threads)
+                PapelTrava papel = trava_definir_papel(PAPEL_COORDENADOR);
+                int ch;
+                int teclas = 0;
+                while ((ch = getch()) != ERR) {
+                    teclas++;
+                    if (!tratar_tecla_coordenador(g, ch, buffer_instrucao_global, &buffer_len)) {
+                        break;
+                    }
+                }
+                // Terminal fechado ou fim do stdin: ele ficaria sempre pronto e
+                // o laço giraria sem parar; seguir só com o timer e os sinais
+                if ((eventos[i].events & (EPOLLHUP | EPOLLERR)) || teclas == 0) {
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+                }
+                // Aplicar os comandos enviados por estas teclas
+                simular_aplicar_comandos(g);
+                trava_definir_papel(papel);
+            }
+        }
+
+        // Avançar a simulação até o instante atual
+        long long decorrido_ms = (agora_ns() - inicio_ns) / 1000000LL;
+        if (decorrido_ms > ms_simulados) {
+            simular_tick(g, (int)(decorrido_ms - ms_simulados));
+            ms_simulados = decorrido_ms;
+        }
+
+        if (!g->jogo_rodando || g->jogo_terminou) {
+            break;
+        }
+
+        PapelTrava papel = trava_definir_papel(PAPEL_EXIBICAO);
+        publicar_retrato_tela(g, buffer_instrucao_global);
+        int espera_ms = simular_ms_ate_proximo_evento(g);
+        if (retrato_tela_pendente(g) || redesenhar) {
+            long long agora = agora_ns();
+            if (agora >= proximo_quadro_ns) {
+                const RetratoTela *retrato = obter_retrato_tela(g);
+                long bytes = desenhar_tela(retrato);
+                registrar_quadro_desenhado(g, retrato, bytes);
+                repassar_linhas_modulos(g);
+                proximo_quadro_ns = agora + intervalo_quadro_ns;
+                redesenhar = 0;
+            } else {
+                int espera_quadro_ms = (int)((proximo_quadro_ns - agora + 999999) / 1000000);
+                if (espera_quadro_ms < espera_ms) {
+                    espera_ms = espera_quadro_ms;
+                }
+            }
+        }
+        trava_definir_papel(papel);
+        armar_timer(timer_fd, espera_ms);
+    }
+
+    close(epoll_fd);
+    close(timer_fd);
+    close(sinal_fd);
+    sigprocmask(SIG_SETMASK, &sinais_anteriores, NULL);
+    return 1;
+}
@@ -0,0 +1,18 @@
+#ifndef REATOR_H
+#define REATOR_H
+
+#include "../game/game.h"
+
+// Modo reator: roda a partida inteira em uma única thread, guiada por um laço
+// epoll sobre stdin (teclas), um timerfd (próximo evento do jogo) e um
+// signalfd (SIGWINCH/SIGINT/SIGTERM). Substitui as threads de mural, exibição,
+// tedax e coordenador e o laço de ticks do main; a thread só acorda quando há
+// tecla, sinal ou mudança de estado agendada.
+//
+// Espera o jogo já inicializado por inicializar_jogo e retorna quando a partida
+// termina, com o ncurses ainda ativo (igual ao modo com threads).
+// Retorna 1 se a partida rodou no reator, 0 se epoll/timerfd/signalfd não
+// estão disponíveis (o chamador deve usar o modo com threads)
+int executar_reator(GameState *g);
+
+#endif // REATOR_H
@@ -0,0 +1,283 @@
+#define _POSIX_C_SOURCE 200809L
+#include "replay.h"
+#include "../game/simulacao.h"
+#include "../game/pool.h"
+#include "../fases/fases.h"
+#include "../estatisticas/estatisticas.h"
+#include "../telemetria/telemetria.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Tick (0.2s) da partida em que g está agora: o do motor de simulação quando
+// simular_tick dirige a partida (reator, replay) ou o tempo decorrido desde o
+// início no modo com threads
+static long tick_atual(const GameState *g) {
+    if (g->modo_threads) {
+        return (long)((agora_ns() - g->inicio_ns) / (SIM_TICK_MURAL_MS * 1000000LL));
+    }
+    return g->sim_ticks;
+}
+
+// Grava o cabeçalho da partida e passa a gravar em g
+void replay_gravar_inicio(GameState *g, FILE *arquivo) {
+    const ConfigFase *c = obter_config_fase(g->dificuldade);
+
+    fprintf(arquivo, "partida %d\n", REPLAY_VERSAO);
+    fprintf(arquivo, "semente %llu\n", (unsigned long long)g->semente);
+    fprintf(arquivo, "jogo %d %d %d\n", (int)g->dificuldade, g->qtd_tedax, g->qtd_bancadas);
+    fprintf(arquivo, "fase %d %d %d %d %d %d %d %d\n",
+            c->num_tedax, c->num_bancadas, c->modulos_necessarios, c->intervalo_geracao,
+            c->modulos_iniciais, c->tempo_total_partida, c->tempo_minimo_execucao,
+            c->tempo_variacao_execucao);
+    g->gravacao = arquivo;
+}
+
+// Grava um comando que está sendo aplicado
+void replay_gravar_comando(GameState *g, const Comando *cmd) {
+    if (!g->gravacao) {
+        return;
+    }
+    fprintf(g->gravacao, "c %ld %d %d %d %s\n", tick_atual(g),
+            cmd->tedax_idx, cmd->bancada_idx, cmd->modulo_id, cmd->instrucao);
+}
+
+// Grava a linha "fim" com o estado final e para de gravar em g
+void replay_gravar_fim(GameState *g) {
+    if (!g->gravacao) {
+        return;
+    }
+    trava_travar(&g->trava_modulos);
+    int resolvidos = contar_modulos_resolvidos(g);
+    trava_destravar(&g->trava_modulos);
+
+    fprintf(g->gravacao, "fim %ld %d %d %d %d %016llx\n", tick_atual(g),
+            g->tempo_restante, resolvidos, g->erros_cometidos, g->qtd_modulos,
+            (unsigned long long)replay_resumo_estado(g));
+    fflush(g->gravacao);
+    g->gravacao = NULL;
+}
+
+// FNV-1a de 64 bits, um inteiro por vez
+static uint64_t misturar(uint64_t hash, long long valor) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (uint64_t)(valor >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t misturar_texto(uint64_t hash, const char *texto) {
+    for (; *texto; texto++) {
+        hash ^= (unsigned char)*texto;
+        hash *= 1099511628211ULL;
+    }
+    return misturar(hash, 0); // separa um texto do seguinte
+}
+
+// ID do módulo do handle, ou -1
+static int id_do_handle(const PoolModulos *pool, HandleModulo handle) {
+    const Modulo *m = pool_modulos_obter(pool, handle);
+    return m ? m->id : -1;
+}
+
+// Resumo (hash FNV-1a) do estado da partida
+uint64_t replay_resumo_estado(const GameState *g) {
+    const PoolModulos *pool = &g->modulos;
+    uint64_t hash = 14695981039346656037ULL;
+
+    hash = misturar(hash, g->tempo_restante);
+    hash = misturar(hash, g->qtd_modulos);
+    hash = misturar(hash, g->modulos_reciclados);
+    hash = misturar(hash, g->erros_cometidos);
+    hash = misturar(hash, g->jogo_terminou);
+
+    // Módulos vivos na ordem de criação
+    for (HandleModulo h = pool_modulos_primeiro(pool); h != MODULO_NENHUM;
+         h = pool_modulos_proximo(pool, h)) {
+        const Modulo *m = pool_modulos_obter(pool, h);
+        int slot = pool_modulos_slot(pool, h);
+        hash = misturar(hash, m->id);
+        hash = misturar(hash, pool->tipo[slot]);
+        hash = misturar(hash, pool->estado[slot]);
+        hash = misturar(hash, pool->tempo_total[slot]);
+        hash = misturar(hash, pool->tempo_restante[slot]);
+        hash = misturar(hash, pool->instante_resolvido[slot]);
+        hash = misturar_texto(hash, m->instrucao_correta);
+        hash = misturar_texto(hash, m->instrucao_digitada);
+    }
+
+    for (int i = 0; i < g->qtd_tedax; i++) {
+        const Tedax *t = &g->tedax[i];
+        hash = misturar(hash, t->estado);
+        hash = misturar(hash, id_do_handle(pool, t->modulo_atual));
+        hash = misturar(hash, t->bancada_atual);
+        hash = misturar(hash, t->qtd_fila > 0 ? id_do_handle(pool, t->fila_modulos[0]) : -1);
+    }
+    for (int i = 0; i < g->qtd_bancadas; i++) {
+        const Bancada *b = &g->bancadas[i];
+        hash = misturar(hash, b->estado);
+        hash = misturar(hash, b->tedax_ocupando);
+        hash = misturar(hash, b->tedax_esperando);
+    }
+    return hash;
+}
+
+// Roda a simulação até o tick indicado (ou até a partida terminar)
+static void avancar_ate(GameState *g, long tick) {
+    while (g->sim_ticks < tick && !g->jogo_terminou) {
+        long ticks = tick - g->sim_ticks;
+        if (ticks > 1000) ticks = 1000;
+        simular_tick(g, (int)ticks * SIM_TICK_MURAL_MS);
+    }
+}
+
+// Cabeçalho de uma partida gravada
+typedef struct {
+    int versao;
+    unsigned long long semente;
+    int dificuldade;
+    int qtd_tedax;
+    int qtd_bancadas;
+    ConfigFase fase;
+} CabecalhoReplay;
+
+// Compara a ConfigFase gravada com a atual (regras mudaram desde a gravação?)
+static int fase_igual(const ConfigFase *a, const ConfigFase *b) {
+    return a->num_tedax == b->num_tedax && a->num_bancadas == b->num_bancadas &&
+           a->modulos_necessarios == b->modulos_necessarios &&
+           a->intervalo_geracao == b->intervalo_geracao &&
+           a->modulos_iniciais == b->modulos_iniciais &&
+           a->tempo_total_partida == b->tempo_total_partida &&
+           a->tempo_minimo_execucao == b->tempo_minimo_execucao &&
+           a->tempo_variacao_execucao == b->tempo_variacao_execucao;
+}
+
+// Lê uma linha "c" para cmd; a instrução é o resto da linha (pode ter espaços)
+static int ler_comando(const char *linha, long *tick, Comando *cmd) {
+    int lidos = 0;
+    if (sscanf(linha, "c %ld %d %d %d%n", tick, &cmd->tedax_idx, &cmd->bancada_idx,
+               &cmd->modulo_id, &lidos) != 4) {
+        return 0;
+    }
+    const char *instrucao = linha + lidos;
+    if (*instrucao == ' ') instrucao++;
+    size_t len = strcspn(instrucao, "\n");
+    if (len >= sizeof(cmd->instrucao)) len = sizeof(cmd->instrucao) - 1;
+    memcpy(cmd->instrucao, instrucao, len);
+    cmd->instrucao[len] = '\0';
+    cmd->tecla_ns = 0;
+    cmd->enter_ns = 0;
+    return 1;
+}
+
+// Refaz todas as partidas gravadas em caminho
+int replay_executar_arquivo(const char *caminho, FILE *saida, int *total) {
+    *total = 0;
+    FILE *arquivo = fopen(caminho, "r");
+    if (!arquivo) {
+        fprintf(saida, "%s: nao foi possivel abrir\n", caminho);
+        return -1;
+    }
+
+    GameState *g = malloc(sizeof(GameState));
+    if (!g) {
+        fclose(arquivo);
+        return -1;
+    }
+
+    CabecalhoReplay cab;
+    memset(&cab, 0, sizeof(cab));
+    char linha[256];
+    int numero_linha = 0;
+    int em_partida = 0;         // 1 entre a linha "fase" e a linha "fim"
+    int comandos = 0;
+    int divergentes = 0;
+    int malformado = 0;
+
+    while (!malformado && fgets(linha, sizeof(linha), arquivo)) {
+        numero_linha++;
+        long tick;
+        Comando cmd;
+        int tempo, resolvidos, erros, modulos;
+        unsigned long long resumo;
+        ConfigFase *f = &cab.fase;
+
+        if (sscanf(linha, "partida %d", &cab.versao) == 1) {
+            malformado = em_partida || cab.versao != REPLAY_VERSAO;
+        } else if (sscanf(linha, "semente %llu", &cab.semente) == 1) {
+            malformado = em_partida;
+        } else if (sscanf(linha, "jogo %d %d %d", &cab.dificuldade, &cab.qtd_tedax,
+                          &cab.qtd_bancadas) == 3) {
+            malformado = em_partida || cab.dificuldade < DIFICULDADE_FACIL ||
+                         cab.dificuldade > DIFICULDADE_DIFICIL;
+        } else if (sscanf(linha, "fase %d %d %d %d %d %d %d %d", &f->num_tedax,
+                          &f->num_bancadas, &f->modulos_necessarios, &f->intervalo_geracao,
+                          &f->modulos_iniciais, &f->tempo_total_partida,
+                          &f->tempo_minimo_execucao, &f->tempo_variacao_execucao) == 8) {
+            if (em_partida) {
+                malformado = 1;
+                continue;
+            }
+            // Cabeçalho completo: começar a partida com a mesma semente
+            inicializar_jogo(g, (Dificuldade)cab.dificuldade, cab.qtd_tedax, cab.qtd_bancadas,
+                             cab.semente);
+            if (!fase_igual(&cab.fase, obter_config_fase(g->dificuldade))) {
+                fprintf(saida, "%s:%d: aviso: a fase mudou desde a gravacao "
+                        "(refazendo com as regras atuais)\n", caminho, numero_linha);
+            }
+            em_partida = 1;
+            comandos = 0;
+        } else if (ler_comando(linha, &tick, &cmd)) {
+            if (!em_partida) {
+                malformado = 1;
+                continue;
+            }
+            avancar_ate(g, tick);
+            simular_aplicar_comando(g, &cmd);
+            comandos++;
+        } else if (sscanf(linha, "fim %ld %d %d %d %d %llx", &tick, &tempo, &resolvidos,
+                          &erros, &modulos, &resumo) == 6) {
+            if (!em_partida) {
+                malformado = 1;
+                continue;
+            }
+            avancar_ate(g, tick);
+
+            int resolvidos_agora = contar_modulos_resolvidos(g);
+            unsigned long long resumo_agora = replay_resumo_estado(g);
+            (*total)++;
+            if (resumo_agora == resumo && g->tempo_restante == tempo &&
+                resolvidos_agora == resolvidos && g->erros_cometidos == erros &&
+                g->qtd_modulos == modulos) {
+                fprintf(saida, "%s: partida %d (semente %llu, %d comandos): OK\n",
+                        caminho, *total, cab.semente, comandos);
+            } else {
+                divergentes++;
+                fprintf(saida, "%s: partida %d (semente %llu, %d comandos): DIVERGIU "
+                        "tempo %d/%d resolvidos %d/%d erros %d/%d modulos %d/%d "
+                        "(refeito/gravado)\n",
+                        caminho, *total, cab.semente, comandos,
+                        g->tempo_restante, tempo, resolvidos_agora, resolvidos,
+                        g->erros_cometidos, erros, g->qtd_modulos, modulos);
+            }
+            // A partida refeita também gera telemetria (pelo relógio da simulação)
+            telemetria_registrar_partida(g);
+            finalizar_jogo(g);
+            em_partida = 0;
+        } else if (linha[0] != '\n' && linha[0] != '#') {
+            malformado = 1;
+        }
+    }
+
+    if (malformado) {
+        fprintf(saida, "%s:%d: linha invalida\n", caminho, numero_linha);
+    } else if (em_partida) {
+        fprintf(saida, "%s: ultima partida sem linha \"fim\" (ignorada)\n", caminho);
+    }
+    if (em_partida) {
+        finalizar_jogo(g);
+    }
+    free(g);
+    fclose(arquivo);
+    return malformado ? -1 : divergentes;
+}
@@ -0,0 +1,50 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../game/game.h"
+
+// Registro de partidas para replay: a semente, a ConfigFase usada e cada
+// comando aplicado com o tick (0.2s) em que foi aplicado. Com isso a partida
+// inteira pode ser refeita pelo motor de simulação (simular_tick), sem
+// ncurses e sem esperar o tempo real, e o estado final comparado com o gravado.
+//
+// Formato (texto, uma partida após a outra no mesmo arquivo):
+//   partida 1
+//   semente <n>
+//   jogo <dificuldade> <tedax> <bancadas>
+//   fase <os 8 campos de ConfigFase, na ordem da struct>
+//   c <tick> <tedax_idx> <bancada_idx> <modulo_id> <instrucao>   (um por comando)
+//   fim <tick> <tempo_restante> <resolvidos> <erros> <modulos> <resumo>
+//
+// Partidas do reator (--reator) são refeitas exatamente: os comandos são
+// aplicados entre dois ticks. No modo com threads o tick vem do relógio real e
+// a ordem entre as threads não se repete, então o replay é aproximado.
+
+// Versão do formato (linha "partida")
+#define REPLAY_VERSAO 1
+
+// Grava o cabeçalho da partida recém-inicializada e passa a gravar em g
+// (g->gravacao); quem chama continua dono do arquivo
+void replay_gravar_inicio(GameState *g, FILE *arquivo);
+
+// Grava um comando que está sendo aplicado (não faz nada se g->gravacao é NULL)
+// NOTA: Só quem aplica os comandos (consumidor de g->comandos) pode chamar
+void replay_gravar_comando(GameState *g, const Comando *cmd);
+
+// Grava a linha "fim" com o estado final e para de gravar em g
+void replay_gravar_fim(GameState *g);
+
+// Resumo (hash FNV-1a) do estado da partida: módulos vivos, tedax, bancadas,
+// relógio e contadores. Duas partidas com o mesmo resumo terminaram iguais
+// NOTA: Lê o estado sem travas; chamar só com a partida parada
+uint64_t replay_resumo_estado(const GameState *g);
+
+// Refaz todas as partidas gravadas em caminho, o mais rápido possível, e
+// escreve em saida uma linha por partida (OK ou DIVERGIU com o que mudou)
+// Retorna o número de partidas que divergiram, ou -1 se o arquivo não abre
+// ou está malformado; *total recebe quantas partidas foram refeitas
+int replay_executar_arquivo(const char *caminho, FILE *saida, int *total);
+
+#endif // REPLAY_H
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+#include "telemetria.h"
+#include "../estatisticas/estatisticas.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Tempo do tedax em cada estado até agora (o estado atual ainda está aberto)
+static void tempos_tedax(const Tedax *t, long long agora, long long tempos[3]) {
+    for (int e = 0; e < 3; e++) {
+        tempos[e] = t->tempo_estado_ms[e];
+    }
+    tempos[t->estado] += agora - t->estado_desde_ms;
+}
+
+// Tempo ocupada da bancada até agora
+static long long tempo_ocupada(const Bancada *b, long long agora) {
+    long long tempo = b->tempo_ocupada_ms;
+    if (b->estado == BANCADA_OCUPADA) {
+        tempo += agora - b->ocupada_desde_ms;
+    }
+    return tempo;
+}
+
+static const char* nome_modo(const GameState *g) {
+    if (g->modo_reator) return "reator";
+    if (g->modo_threads) return "threads";
+    return "simulacao"; // replay ou simular_tick direto
+}
+
+// Soma os contadores da partida em r
+void telemetria_resumir(const GameState *g, ResumoTelemetria *r) {
+    memset(r, 0, sizeof(*r));
+    long long agora = instante_partida_ms(g);
+    r->duracao_ms = agora;
+    r->resolvidos = contar_modulos_resolvidos(g);
+    r->vitoria = todos_modulos_resolvidos(g) && g->qtd_modulos > 0;
+    r->resolvidos_por_minuto = agora > 0 ? r->resolvidos * 60000.0 / agora : 0.0;
+    r->pendentes_fim = g->modulos_por_estado[MOD_PENDENTE].qtd;
+
+    for (int i = 0; i < g->qtd_tedax; i++) {
+        const Tedax *t = &g->tedax[i];
+        long long tempos[3];
+        tempos_tedax(t, agora, tempos);
+        for (int e = 0; e < 3; e++) {
+            r->tedax_ms[e] += tempos[e];
+        }
+        // Uma espera ainda aberta no fim também conta para o máximo
+        long long espera_max = t->espera_max_ms;
+        if (t->estado == TEDAX_ESPERANDO && agora - t->estado_desde_ms > espera_max) {
+            espera_max = agora - t->estado_desde_ms;
+        }
+        r->esperas += t->qtd_esperas;
+        if (espera_max > r->espera_max_ms) {
+            r->espera_max_ms = espera_max;
+        }
+    }
+
+    long long ocupadas_ms = 0;
+    for (int i = 0; i < g->qtd_bancadas; i++) {
+        ocupadas_ms += tempo_ocupada(&g->bancadas[i], agora);
+    }
+    if (agora > 0 && g->qtd_bancadas > 0) {
+        r->utilizacao_bancadas = (double)ocupadas_ms / ((double)agora * g->qtd_bancadas);
+    }
+}
+
+// Escreve o registro JSON (uma linha) da partida
+void telemetria_escrever_json(const GameState *g, FILE *saida) {
+    ResumoTelemetria r;
+    telemetria_resumir(g, &r);
+    const Histograma *h = &g->hist_pendente;
+    long long agora = r.duracao_ms;
+
+    fprintf(saida, "{\"data\":%lld,\"dificuldade\":\"%s\",\"modo\":\"%s\",\"semente\":%llu,",
+            (long long)time(NULL), nome_dificuldade(g->dificuldade), nome_modo(g),
+            (unsigned long long)g->semente);
+    fprintf(saida, "\"duracao_ms\":%lld,\"vitoria\":%s,\"tempo_restante\":%d,"
+            "\"modulos\":%d,\"resolvidos\":%d,\"erros\":%d,\"resolvidos_por_minuto\":%.2f,",
+            r.duracao_ms, r.vitoria ? "true" : "false", g->tempo_restante, g->qtd_modulos,
+            r.resolvidos, g->erros_cometidos, r.resolvidos_por_minuto);
+    fprintf(saida, "\"pendente\":{\"n\":%lld,\"media_ms\":%.1f,\"p50_ms\":%.1f,"
+            "\"p95_ms\":%.1f,\"max_ms\":%.1f},\"pendentes_fim\":%d,",
+            h->total, h->total > 0 ? (double)h->soma_ns / h->total / 1e6 : 0.0,
+            histograma_percentil(h, 50) / 1e6, histograma_percentil(h, 95) / 1e6,
+            h->max_ns / 1e6, r.pendentes_fim);
+
+    fprintf(saida, "\"tedax\":[");
+    for (int i = 0; i < g->qtd_tedax; i++) {
+        const Tedax *t = &g->tedax[i];
+        long long tempos[3];
+        tempos_tedax(t, agora, tempos);
+        fprintf(saida, "%s{\"livre_ms\":%lld,\"ocupado_ms\":%lld,\"esperando_ms\":%lld,"
+                "\"esperas\":%d,\"espera_max_ms\":%lld}", i > 0 ? "," : "",
+                tempos[TEDAX_LIVRE], tempos[TEDAX_OCUPADO], tempos[TEDAX_ESPERANDO],
+                t->qtd_esperas, t->espera_max_ms);
+    }
+    fprintf(saida, "],\"bancadas\":[");
+    for (int i = 0; i < g->qtd_bancadas; i++) {
+        long long ocupada = tempo_ocupada(&g->bancadas[i], agora);
+        fprintf(saida, "%s{\"ocupada_ms\":%lld,\"utilizacao\":%.3f}", i > 0 ? "," : "",
+                ocupada, agora > 0 ? (double)ocupada / agora : 0.0);
+    }
+    fprintf(saida, "]}\n");
+}
+
+// Cabeçalho das linhas de telemetria_escrever_csv
+void telemetria_escrever_cabecalho_csv(FILE *saida) {
+    fprintf(saida, "data,dificuldade,modo,semente,duracao_ms,vitoria,tempo_restante,modulos,"
+            "resolvidos,erros,resolvidos_por_minuto,pendente_n,pendente_media_ms,"
+            "pendente_p50_ms,pendente_p95_ms,pendente_max_ms,pendentes_fim,tedax,"
+            "tedax_livre_ms,tedax_ocupado_ms,tedax_esperando_ms,esperas,espera_max_ms,"
+            "bancadas,utilizacao_bancadas\n");
+}
+
+// Escreve a linha CSV da partida (tempos de tedax somados, bancadas em média)
+void telemetria_escrever_csv(const GameState *g, FILE *saida) {
+    ResumoTelemetria r;
+    telemetria_resumir(g, &r);
+    const Histograma *h = &g->hist_pendente;
+
+    fprintf(saida, "%lld,%s,%s,%llu,%lld,%d,%d,%d,%d,%d,%.2f,",
+            (long long)time(NULL), nome_dificuldade(g->dificuldade), nome_modo(g),
+            (unsigned long long)g->semente, r.duracao_ms, r.vitoria, g->tempo_restante,
+            g->qtd_modulos, r.resolvidos, g->erros_cometidos, r.resolvidos_por_minuto);
+    fprintf(saida, "%lld,%.1f,%.1f,%.1f,%.1f,%d,",
+            h->total, h->total > 0 ? (double)h->soma_ns / h->total / 1e6 : 0.0,
+            histograma_percentil(h, 50) / 1e6, histograma_percentil(h, 95) / 1e6,
+            h->max_ns / 1e6, r.pendentes_fim);
+    fprintf(saida, "%d,%lld,%lld,%lld,%d,%lld,%d,%.3f\n",
+            g->qtd_tedax, r.tedax_ms[TEDAX_LIVRE], r.tedax_ms[TEDAX_OCUPADO],
+            r.tedax_ms[TEDAX_ESPERANDO], r.esperas, r.espera_max_ms,
+            g->qtd_bancadas, r.utilizacao_bancadas);
+}
+
+// Acrescenta o registro da partida ao arquivo de $TEDAX_TELEMETRIA
+int telemetria_registrar_partida(const GameState *g) {
+    const char *caminho = getenv("TEDAX_TELEMETRIA");
+    if (!caminho || caminho[0] == '\0') {
+        return 0;
+    }
+    FILE *arquivo = fopen(caminho, "a");
+    if (!arquivo) {
+        fprintf(stderr, "Aviso: nao foi possivel abrir %s para a telemetria\n", caminho);
+        return 0;
+    }
+
+    size_t len = strlen(caminho);
+    if (len >= 4 && strcmp(caminho + len - 4, ".csv") == 0) {
+        // Cabeçalho só na primeira linha do arquivo
+        fseek(arquivo, 0, SEEK_END);
+        if (ftell(arquivo) == 0) {
+            telemetria_escrever_cabecalho_csv(arquivo);
+        }
+        telemetria_escrever_csv(g, arquivo);
+    } else {
+        telemetria_escrever_json(g, arquivo);
+    }
+    fclose(arquivo);
+    return 1;
+}
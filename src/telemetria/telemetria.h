@@ -0,0 +1,48 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdio.h>
+#include "../game/game.h"
+
+// Telemetria das partidas: um registro por partida com a vazão (módulos
+// resolvidos por minuto), o tempo de cada tedax livre, ocupado e esperando
+// bancada, a utilização de cada bancada e quanto os módulos ficaram pendentes.
+// Os contadores são mantidos durante a partida (mudar_estado_tedax,
+// mudar_estado_modulo e a ocupação das bancadas) pelo relógio da partida
+// (instante_partida_ms); aqui eles só são somados e escritos.
+//
+// Destino: arquivo indicado pela variável de ambiente TEDAX_TELEMETRIA, em
+// append. Terminado em ".csv", uma linha CSV por partida (só os totais, com
+// cabeçalho quando o arquivo está vazio); senão, um objeto JSON por linha,
+// com o detalhe de cada tedax e de cada bancada.
+
+// Totais de uma partida
+typedef struct {
+    long long duracao_ms;
+    int vitoria;
+    int resolvidos;
+    double resolvidos_por_minuto;
+    int pendentes_fim;          // módulos ainda pendentes no fim (fora de hist_pendente)
+    long long tedax_ms[3];      // soma dos tedax em cada EstadoTedax
+    int esperas;                // saídas de TEDAX_ESPERANDO, somadas
+    long long espera_max_ms;    // maior espera contínua de um tedax
+    double utilizacao_bancadas; // fração do tempo com bancada ocupada (média das bancadas)
+} ResumoTelemetria;
+
+// Soma os contadores da partida em r
+// NOTA: Lê o estado sem travas; chamar só com a partida parada
+void telemetria_resumir(const GameState *g, ResumoTelemetria *r);
+
+// Escreve o registro JSON (uma linha) da partida em saida
+void telemetria_escrever_json(const GameState *g, FILE *saida);
+
+// Escreve a linha CSV da partida em saida (cabeçalho: telemetria_escrever_cabecalho_csv)
+void telemetria_escrever_csv(const GameState *g, FILE *saida);
+void telemetria_escrever_cabecalho_csv(FILE *saida);
+
+// Acrescenta o registro da partida ao arquivo de $TEDAX_TELEMETRIA
+// Não faz nada se a variável não está definida; retorna 1 se escreveu
+// NOTA: Chamar só com a partida parada (depois dos joins / do fim do reator)
+int telemetria_registrar_partida(const GameState *g);
+
+#endif // TELEMETRIA_H
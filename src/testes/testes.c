@@ -0,0 +1,545 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <sched.h>
+#include "../game/game.h"
+#include "../game/comandos.h"
+#include "../game/ordem.h"
+#include "../game/simulacao.h"
+#include "../replay/replay.h"
+#include "../modulos/modulos.h"
+
+// Testes de regressão (make test)
+// Cada teste verifica uma garantia que outras partes do jogo assumem; a saída
+// traz uma linha "ok" ou "FALHOU" por teste e o programa retorna 1 se algum
+// falhou. Nada aqui abre o terminal.
+
+// Globais que main.c define para o jogo (usadas por threads.c, reator.c e ui.c)
+char buffer_instrucao_global[64] = "";
+int audio_disponivel_global = 0;
+
+typedef struct {
+    const char *nome;
+    int (*executar)(void);      // retorna 1 se passou
+} Teste;
+
+// Motivo da falha do teste em andamento (impresso depois do nome)
+static char motivo[256];
+
+static int falhar(const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(motivo, sizeof(motivo), formato, args);
+    va_end(args);
+    return 0;
+}
+
+// ============================================================================
+// FILA DE COMANDOS
+// ============================================================================
+
+#define FILA_PRODUTORES 3
+#define FILA_COMANDOS_POR_PRODUTOR 200000
+
+static FilaComandos fila;
+
+// Envia FILA_COMANDOS_POR_PRODUTOR comandos numerados (modulo_id) com o índice
+// do produtor em tedax_idx, esperando a vez quando a fila está cheia
+static void* produtor_fila(void *arg) {
+    int produtor = (int)(long)arg;
+    Comando cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.tedax_idx = produtor;
+    for (int i = 0; i < FILA_COMANDOS_POR_PRODUTOR; i++) {
+        cmd.modulo_id = i;
+        snprintf(cmd.instrucao, sizeof(cmd.instrucao), "%d", i);
+        while (!fila_comandos_enviar(&fila, &cmd)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Vários produtores e um consumidor: todo comando chega exatamente uma vez,
+// inteiro, e os de um mesmo produtor chegam na ordem em que foram enviados
+static int teste_fila_comandos(void) {
+    fila_comandos_inicializar(&fila);
+    pthread_t produtores[FILA_PRODUTORES];
+    for (long p = 0; p < FILA_PRODUTORES; p++) {
+        pthread_create(&produtores[p], NULL, produtor_fila, (void *)p);
+    }
+
+    int proximo[FILA_PRODUTORES] = {0};
+    int recebidos = 0;
+    int ok = 1;
+    while (recebidos < FILA_PRODUTORES * FILA_COMANDOS_POR_PRODUTOR) {
+        Comando cmd;
+        if (!fila_comandos_receber(&fila, &cmd)) {
+            sched_yield();
+            continue;
+        }
+        recebidos++;
+        if (!ok) {
+            continue; // esvazia a fila para os produtores terminarem
+        }
+        char esperado[16];
+        snprintf(esperado, sizeof(esperado), "%d", cmd.modulo_id);
+        if (cmd.tedax_idx < 0 || cmd.tedax_idx >= FILA_PRODUTORES) {
+            ok = falhar("produtor invalido %d", cmd.tedax_idx);
+        } else if (cmd.modulo_id != proximo[cmd.tedax_idx]) {
+            ok = falhar("produtor %d: recebido %d, esperado %d", cmd.tedax_idx,
+                        cmd.modulo_id, proximo[cmd.tedax_idx]);
+        } else if (strcmp(cmd.instrucao, esperado) != 0) {
+            ok = falhar("produtor %d: comando %d corrompido", cmd.tedax_idx, cmd.modulo_id);
+        } else {
+            proximo[cmd.tedax_idx]++;
+        }
+    }
+    for (int p = 0; p < FILA_PRODUTORES; p++) {
+        pthread_join(produtores[p], NULL);
+    }
+
+    Comando sobra;
+    if (ok && fila_comandos_receber(&fila, &sobra)) {
+        ok = falhar("comando a mais na fila");
+    }
+    return ok;
+}
+
+// ============================================================================
+// MÓDULO DE FIOS
+// ============================================================================
+
+// Regras do módulo de fios como eram antes da tabela de respostas: lê o texto
+// da sequência ("/R/G/B/Y/W/") com strtok e compara as cores com strcmp
+static int resposta_fios_referencia(int padrao, const char *sequencia_texto) {
+    static const char *cores_fios[] = {"R", "G", "B", "Y", "W", "K"};
+    char sequencia[32];
+    strcpy(sequencia, sequencia_texto);
+
+    int num_fios = 0;
+    char *token = strtok(sequencia, "/");
+    char cores[10][4];
+    while (token != NULL && num_fios < 10) {
+        strcpy(cores[num_fios], token);
+        num_fios++;
+        token = strtok(NULL, "/");
+    }
+
+    int posicao_cortar = -1;
+    switch (padrao) {
+        case 0:
+            for (int i = 0; i < num_fios; i++) {
+                if (strcmp(cores[i], "R") == 0 || strcmp(cores[i], "G") == 0 ||
+                    strcmp(cores[i], "B") == 0) {
+                    posicao_cortar = i + 1;
+                    break;
+                }
+            }
+            if (posicao_cortar == -1) posicao_cortar = 1;
+            break;
+        case 1: {
+            int tem_amarelo = 0;
+            for (int i = 0; i < num_fios; i++) {
+                if (strcmp(cores[i], "Y") == 0) tem_amarelo = 1;
+            }
+            posicao_cortar = tem_amarelo ? num_fios : 1;
+            break;
+        }
+        case 2: {
+            int tem_preto = 0;
+            for (int i = 0; i < num_fios; i++) {
+                if (strcmp(cores[i], "K") == 0) tem_preto = 1;
+            }
+            posicao_cortar = tem_preto ? 1 : 2;
+            break;
+        }
+        case 3: {
+            int contadores[6] = {0};
+            for (int i = 0; i < num_fios; i++) {
+                for (int c = 0; c < 6; c++) {
+                    if (strcmp(cores[i], cores_fios[c]) == 0) contadores[c]++;
+                }
+            }
+            int max_idx = 0;
+            for (int c = 1; c < 6; c++) {
+                if (contadores[c] > contadores[max_idx]) max_idx = c;
+            }
+            for (int i = 0; i < num_fios; i++) {
+                if (strcmp(cores[i], cores_fios[max_idx]) == 0) {
+                    posicao_cortar = i + 1;
+                    break;
+                }
+            }
+            if (posicao_cortar == -1) posicao_cortar = 1;
+            break;
+        }
+        case 4:
+            posicao_cortar = (num_fios + 1) / 2;
+            break;
+    }
+    return posicao_cortar;
+}
+
+// Todas as 6^5 sequências nos 5 padrões: a tabela aceita a posição que as
+// regras antigas mandam cortar, e só ela
+static int teste_fios_tabela(void) {
+    static const char letras[] = "RGBYWK";
+    Modulo mod;
+    memset(&mod, 0, sizeof(mod));
+    mod.tipo = TIPO_FIOS;
+
+    int sequencias = 1;
+    for (int i = 0; i < FIOS_POR_MODULO; i++) {
+        sequencias *= 6;
+    }
+    for (int padrao = 0; padrao < FIOS_PADROES; padrao++) {
+        for (int s = 0; s < sequencias; s++) {
+            uint16_t cores = 0;
+            char *texto = mod.dados.fios.sequencia;
+            *texto++ = '/';
+            int resto = s;
+            for (int i = 0; i < FIOS_POR_MODULO; i++) {
+                cores |= (uint16_t)((resto % 6) << (3 * i));
+                *texto++ = letras[resto % 6];
+                *texto++ = '/';
+                resto /= 6;
+            }
+            *texto = '\0';
+            mod.dados.fios.padrao = padrao;
+            mod.dados.fios.cores = cores;
+
+            int esperada = resposta_fios_referencia(padrao, mod.dados.fios.sequencia);
+            for (int posicao = 1; posicao <= FIOS_POR_MODULO; posicao++) {
+                char instrucao[2] = {(char)('0' + posicao), '\0'};
+                if (validar_instrucao_fios(&mod, instrucao) != (posicao == esperada)) {
+                    return falhar("padrao %d, %s: tabela %s %d, regras cortam %d", padrao,
+                                  mod.dados.fios.sequencia,
+                                  posicao == esperada ? "recusa" : "aceita", posicao, esperada);
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+// Módulos de fios gerados: a instrução correta é a das regras antigas para o
+// texto exibido (as cores empacotadas e o texto descrevem a mesma sequência)
+static int teste_fios_gerados(void) {
+    Aleatorio aleatorio;
+    aleatorio_semear(&aleatorio, 14, 0);
+    for (int i = 0; i < 100000; i++) {
+        Modulo mod;
+        gerar_modulo_fios(&mod, DIFICULDADE_DIFICIL, &aleatorio);
+        char esperada[2] = {(char)('0' + resposta_fios_referencia(mod.dados.fios.padrao,
+                                                                   mod.dados.fios.sequencia)),
+                            '\0'};
+        if (strcmp(mod.instrucao_correta, esperada) != 0) {
+            return falhar("padrao %d, %s: gerado %s, regras cortam %s", mod.dados.fios.padrao,
+                          mod.dados.fios.sequencia, mod.instrucao_correta, esperada);
+        }
+    }
+    return 1;
+}
+
+// ============================================================================
+// LISTA DA TELA (ORDEM)
+// ============================================================================
+
+#define ORDEM_SLOTS 1000
+#define ORDEM_OPERACOES 200000
+
+// Referência: slots vivos na ordem de criação e, por slot, tipo/estado/visível
+static int ordem_criacao[ORDEM_OPERACOES + ORDEM_SLOTS];
+static int ordem_qtd_criacao;
+static int ref_criacao[ORDEM_SLOTS];     // entrada atual do slot em ordem_criacao
+static unsigned char ref_vivo[ORDEM_SLOTS], ref_tipo[ORDEM_SLOTS], ref_estado[ORDEM_SLOTS],
+                     ref_visivel[ORDEM_SLOTS];
+
+// Compara contagem, busca e percurso de todos os filtros com a referência
+static int conferir_ordem(const OrdemModulos *ordem) {
+    int vivos = 0;
+    for (int i = 0; i < ordem_qtd_criacao; i++) {
+        int slot = ordem_criacao[i];
+        if (ref_vivo[slot] && ref_criacao[slot] == i) {
+            ref_criacao[slot] = vivos;
+            ordem_criacao[vivos++] = slot;
+        }
+    }
+    ordem_qtd_criacao = vivos;
+
+    for (int filtro_tipo = -1; filtro_tipo < 3; filtro_tipo++) {
+        for (int filtro_estado = -1; filtro_estado < 3; filtro_estado++) {
+            int esperados[ORDEM_SLOTS], qtd = 0;
+            for (int i = 0; i < ordem_qtd_criacao; i++) {
+                int slot = ordem_criacao[i];
+                if (ref_visivel[slot] && (filtro_tipo < 0 || filtro_tipo == ref_tipo[slot]) &&
+                    (filtro_estado < 0 || filtro_estado == ref_estado[slot])) {
+                    esperados[qtd++] = slot;
+                }
+            }
+            int contados = ordem_modulos_contar(ordem, filtro_tipo, filtro_estado);
+            if (contados != qtd) {
+                return falhar("filtro %d/%d: contou %d, esperava %d", filtro_tipo, filtro_estado,
+                              contados, qtd);
+            }
+            int k = 0;
+            for (int slot = ordem_modulos_buscar(ordem, filtro_tipo, filtro_estado, 0); slot >= 0;
+                 slot = ordem_modulos_proximo(ordem, filtro_tipo, filtro_estado, slot), k++) {
+                if (k >= qtd || slot != esperados[k]) {
+                    return falhar("filtro %d/%d: percurso deu slot %d na linha %d, esperava %d",
+                                  filtro_tipo, filtro_estado, slot, k, k < qtd ? esperados[k] : -1);
+                }
+            }
+            if (k != qtd) {
+                return falhar("filtro %d/%d: percurso parou em %d de %d linhas", filtro_tipo,
+                              filtro_estado, k, qtd);
+            }
+            if (qtd > 0 && ordem_modulos_buscar(ordem, filtro_tipo, filtro_estado, qtd / 2) !=
+                               esperados[qtd / 2]) {
+                return falhar("filtro %d/%d: busca da linha %d", filtro_tipo, filtro_estado, qtd / 2);
+            }
+        }
+    }
+    return 1;
+}
+
+// Gera, muda, esconde e esquece módulos ao acaso, reaproveitando slots como o
+// pool, e confere o índice contra a referência. Os IDs emitidos passam de
+// 100 mil, mas a capacidade tem de acompanhar os slots (2 x ORDEM_SLOTS)
+static int teste_ordem_indice(void) {
+    OrdemModulos ordem;
+    Aleatorio aleatorio;
+    ordem_modulos_inicializar(&ordem);
+    aleatorio_semear(&aleatorio, 25, 0);
+    memset(ref_vivo, 0, sizeof(ref_vivo));
+    ordem_qtd_criacao = 0;
+
+    int vivos = 0, ok = 1;
+    for (int op = 0; op < ORDEM_OPERACOES && ok; op++) {
+        int slot = (int)aleatorio_abaixo(&aleatorio, ORDEM_SLOTS);
+        int sorteio = (int)aleatorio_abaixo(&aleatorio, 4);
+        if (!ref_vivo[slot]) {
+            if (vivos < ORDEM_SLOTS * 3 / 4 || sorteio == 0) {
+                ref_vivo[slot] = 1;
+                ref_tipo[slot] = (unsigned char)aleatorio_abaixo(&aleatorio, 3);
+                ref_estado[slot] = MOD_PENDENTE;
+                ref_visivel[slot] = 1;
+                ref_criacao[slot] = ordem_qtd_criacao;
+                ordem_criacao[ordem_qtd_criacao++] = slot;
+                vivos++;
+                if (!ordem_modulos_inserir(&ordem, slot, (TipoModulo)ref_tipo[slot], MOD_PENDENTE)) {
+                    ok = falhar("faltou memoria");
+                }
+            }
+        } else if (sorteio == 0) {
+            if (ordem_modulos_remover(&ordem, slot) != ref_visivel[slot]) {
+                ok = falhar("remover o slot %d: visibilidade errada", slot);
+            }
+            ref_vivo[slot] = 0;
+            vivos--;
+        } else if (sorteio == 1) {
+            ref_visivel[slot] = !ref_visivel[slot];
+            ordem_modulos_exibir(&ordem, slot, ref_visivel[slot]);
+        } else {
+            ref_estado[slot] = (unsigned char)aleatorio_abaixo(&aleatorio, 3);
+            ordem_modulos_mudar_estado(&ordem, slot, (EstadoModulo)ref_estado[slot]);
+        }
+        if (ok && op % 997 == 0) {
+            ok = conferir_ordem(&ordem);
+        }
+    }
+    if (ok) {
+        ok = conferir_ordem(&ordem);
+    }
+    if (ok && ordem.capacidade > 2 * 1024) {
+        ok = falhar("capacidade %d para %d slots", ordem.capacidade, ORDEM_SLOTS);
+    }
+    ordem_modulos_finalizar(&ordem);
+    return ok;
+}
+
+// ============================================================================
+// SEMENTE
+// ============================================================================
+
+#define MODULOS_POR_SEMENTE 10000
+
+// Os dois módulos têm o mesmo enigma? (compara o que o jogo mostra e valida,
+// não os bytes: o union dos dados tem padding)
+static int modulos_iguais(const Modulo *a, const Modulo *b) {
+    char info_a[128], info_b[128];
+    obter_info_exibicao_modulo(a, info_a, sizeof(info_a));
+    obter_info_exibicao_modulo(b, info_b, sizeof(info_b));
+    return a->tipo == b->tipo && strcmp(a->instrucao_correta, b->instrucao_correta) == 0 &&
+           strcmp(info_a, info_b) == 0;
+}
+
+// A mesma semente gera os mesmos módulos, bit a bit no que o jogo mostra e
+// valida; outra semente gera outros
+static int teste_semente_modulos(void) {
+    static Modulo primeira[MODULOS_POR_SEMENTE], segunda[MODULOS_POR_SEMENTE];
+    Aleatorio aleatorio;
+
+    aleatorio_semear(&aleatorio, 16, FLUXO_MODULOS);
+    gerar_lote_modulos(primeira, MODULOS_POR_SEMENTE, DIFICULDADE_DIFICIL, &aleatorio);
+    aleatorio_semear(&aleatorio, 16, FLUXO_MODULOS);
+    gerar_lote_modulos(segunda, MODULOS_POR_SEMENTE, DIFICULDADE_DIFICIL, &aleatorio);
+    for (int i = 0; i < MODULOS_POR_SEMENTE; i++) {
+        if (!modulos_iguais(&primeira[i], &segunda[i])) {
+            return falhar("modulo %d difere com a mesma semente (%s x %s)", i,
+                          primeira[i].instrucao_correta, segunda[i].instrucao_correta);
+        }
+    }
+
+    aleatorio_semear(&aleatorio, 17, FLUXO_MODULOS);
+    gerar_lote_modulos(segunda, MODULOS_POR_SEMENTE, DIFICULDADE_DIFICIL, &aleatorio);
+    int iguais_outra_semente = 0;
+    for (int i = 0; i < MODULOS_POR_SEMENTE; i++) {
+        iguais_outra_semente += modulos_iguais(&primeira[i], &segunda[i]);
+    }
+    if (iguais_outra_semente == MODULOS_POR_SEMENTE) {
+        return falhar("sementes 16 e 17 geraram os mesmos modulos");
+    }
+    return 1;
+}
+
+// Joga uma partida inteira pelo motor de simulação, mandando um comando a
+// cada 2 s, e retorna o resumo do estado final
+static uint64_t jogar_partida(GameState *g, uint64_t semente) {
+    static const char *comandos[] = {"p", "pp", "ppp", "1", "3"};
+    inicializar_jogo(g, DIFICULDADE_DIFICIL, 0, 0, semente);
+    for (long tick = 0; !g->jogo_terminou && tick < 100000; tick++) {
+        if (tick % 10 == 0) {
+            simular_comando(g, comandos[(tick / 10) % 5]);
+        }
+        simular_tick(g, SIM_TICK_MURAL_MS);
+    }
+    uint64_t resumo = replay_resumo_estado(g);
+    finalizar_jogo(g);
+    return resumo;
+}
+
+// A mesma semente e os mesmos comandos levam ao mesmo estado final
+static int teste_semente_partida(void) {
+    GameState *g = malloc(sizeof(GameState));
+    if (!g) {
+        return falhar("sem memoria");
+    }
+    uint64_t primeira = jogar_partida(g, 1616);
+    uint64_t segunda = jogar_partida(g, 1616);
+    uint64_t outra = jogar_partida(g, 1617);
+    free(g);
+    if (primeira != segunda) {
+        return falhar("semente 1616: resumo %016llx e depois %016llx",
+                      (unsigned long long)primeira, (unsigned long long)segunda);
+    }
+    if (primeira == outra) {
+        return falhar("sementes 1616 e 1617 terminaram no mesmo estado");
+    }
+    return 1;
+}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+
+#define REPLAY_PARTIDA "src/testes/partida.replay" // relativo à raiz (make test)
+
+// Refaz o arquivo de replay; o texto que ele escreve fica em saida_texto
+static int refazer_replay(const char *caminho, int *total, char *saida_texto, size_t tamanho) {
+    FILE *saida = tmpfile();
+    if (!saida) {
+        return -2;
+    }
+    int divergentes = replay_executar_arquivo(caminho, saida, total);
+    rewind(saida);
+    size_t lidos = fread(saida_texto, 1, tamanho - 1, saida);
+    saida_texto[lidos] = '\0';
+    fclose(saida);
+    return divergentes;
+}
+
+// A partida gravada no repositório é refeita e chega ao mesmo estado final
+static int teste_replay_partida(void) {
+    char texto[1024];
+    int total = 0;
+    int divergentes = refazer_replay(REPLAY_PARTIDA, &total, texto, sizeof(texto));
+    if (divergentes != 0 || total != 1) {
+        return falhar("%d divergentes em %d partidas: %s", divergentes, total, texto);
+    }
+    return 1;
+}
+
+// A mesma partida com a linha "fim" alterada (um erro a mais) é apontada
+// como divergente, não aceita
+static int teste_replay_divergente(void) {
+    FILE *original = fopen(REPLAY_PARTIDA, "r");
+    if (!original) {
+        return falhar("nao foi possivel abrir %s", REPLAY_PARTIDA);
+    }
+    char caminho[] = "/tmp/tedax_replayXXXXXX";
+    int fd = mkstemp(caminho);
+    FILE *alterado = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!alterado) {
+        fclose(original);
+        return falhar("nao foi possivel criar o arquivo temporario");
+    }
+    char linha[256];
+    while (fgets(linha, sizeof(linha), original)) {
+        long tick;
+        int tempo, resolvidos, erros, modulos;
+        unsigned long long resumo;
+        if (sscanf(linha, "fim %ld %d %d %d %d %llx", &tick, &tempo, &resolvidos, &erros,
+                   &modulos, &resumo) == 6) {
+            fprintf(alterado, "fim %ld %d %d %d %d %016llx\n", tick, tempo, resolvidos,
+                    erros + 1, modulos, resumo);
+        } else {
+            fputs(linha, alterado);
+        }
+    }
+    fclose(original);
+    fclose(alterado);
+
+    char texto[1024];
+    int total = 0;
+    int divergentes = refazer_replay(caminho, &total, texto, sizeof(texto));
+    remove(caminho);
+    if (divergentes != 1 || total != 1 || !strstr(texto, "DIVERGIU")) {
+        return falhar("esperado 1 DIVERGIU, veio %d em %d partidas: %s", divergentes, total,
+                      texto);
+    }
+    return 1;
+}
+
+int main(void) {
+    const Teste testes[] = {
+        {"fila_comandos: 3 produtores, 1 consumidor", teste_fila_comandos},
+        {"fios: tabela x regras antigas, 5 padroes x 6^5 sequencias", teste_fios_tabela},
+        {"fios: 100 mil modulos gerados x regras antigas", teste_fios_gerados},
+        {"ordem: indice da lista da tela x referencia, slots reaproveitados", teste_ordem_indice},
+        {"semente: mesmos modulos com a mesma semente", teste_semente_modulos},
+        {"semente: mesma partida com a mesma semente", teste_semente_partida},
+        {"replay: partida gravada refeita (" REPLAY_PARTIDA ")", teste_replay_partida},
+        {"replay: linha fim alterada vira DIVERGIU", teste_replay_divergente},
+    };
+
+    // Os replays refeitos não devem ir para a telemetria de quem roda os testes
+    unsetenv("TEDAX_TELEMETRIA");
+
+    int falhas = 0;
+    for (size_t i = 0; i < sizeof(testes) / sizeof(testes[0]); i++) {
+        motivo[0] = '\0';
+        if (testes[i].executar()) {
+            printf("ok      %s\n", testes[i].nome);
+        } else {
+            printf("FALHOU  %s: %s\n", testes[i].nome, motivo);
+            falhas++;
+        }
+    }
+    printf("%d de %zu testes falharam\n", falhas, sizeof(testes) / sizeof(testes[0]));
+    return falhas > 0 ? 1 : 0;
+}
@@ -1,12 +1,16 @@
 #define _POSIX_C_SOURCE 200809L
 #include "ui.h"
 #include "../game/game.h"
-#include "../modulos/modulos.h"
 #include "../audio/audio.h"
+#include "../modulos/modulos.h"
 #include <ncurses.h>
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 
 // Inicializa o ncurses
 void inicializar_ncurses(void) {
@@ -17,6 +21,7 @@ void inicializar_ncurses(void) {
     curs_set(0);                // Esconde o cursor
     nodelay(stdscr, TRUE);      // getch() não bloqueia
     timeout(0);                 // getch() retorna ERR imediatamente se não houver entrada
+    invalidar_tela();           // a tela da partida começa redesenhando tudo
 }
 
 // Finaliza o ncurses
@@ -59,231 +64,441 @@ void gerar_barra_progresso(char *buffer, int tamanho_buffer, int tempo_total, in
     snprintf(buffer + pos, tamanho_buffer - pos, " %d%%", progresso);
 }
 
-// Desenha toda a interface do jogo na tela
-void desenhar_tela(const GameState *g, const char *buffer_instrucao) {
-    clear();
+// ============================================================================
+// TELA DA PARTIDA
+// ============================================================================
+// A tela é dividida em painéis (janelas ncurses) empilhados de cima para
+// baixo: cabeçalho, tedax, bancadas, módulos, entrada e erro. A cada quadro o
+// retrato é comparado com o último desenhado e só os painéis cujos dados
+// mudaram são redesenhados (wnoutrefresh); um único doupdate manda para o
+// terminal só as células alteradas. Se a altura de algum painel muda (uma
+// linha de fila aparece, o terminal muda de tamanho) os painéis são
+// reposicionados e todos redesenhados.
+// Só a thread que desenha mexe nestes painéis.
+
+typedef enum {
+    PAINEL_CABECALHO,
+    PAINEL_TEDAX,
+    PAINEL_BANCADAS,
+    PAINEL_MODULOS,
+    PAINEL_ENTRADA,
+    PAINEL_ERRO,
+    QTD_PAINEIS
+} Painel;
+
+static struct {
+    WINDOW *janela[QTD_PAINEIS]; // NULL se o painel começa abaixo da tela
+    int y[QTD_PAINEIS];
+    int altura[QTD_PAINEIS];
+    int modulos_visiveis;       // linhas de módulos desenhadas no painel
+    int modulos_capacidade;     // linhas de módulos que cabem no painel
+    int linhas, colunas;        // tamanho do terminal na última disposição
+    int valido;                 // 0: o próximo quadro redesenha tudo
+    RetratoTela anterior;       // último retrato desenhado
+} paineis;
+
+// Faz o próximo quadro reposicionar e redesenhar todos os painéis
+void invalidar_tela(void) {
+    paineis.valido = 0;
+}
+
+// Linhas de módulos que o painel comporta na disposição atual
+int capacidade_lista_modulos(void) {
+    return paineis.valido ? paineis.modulos_capacidade : 0;
+}
+
+// Bytes que esta thread já passou para write() (wchar de /proc/thread-self/io)
+// O arquivo fica aberto e é relido com pread; se a thread que desenha mudou
+// (outra partida) ou a leitura falha, ele é reaberto
+// Retorna -1 se a leitura falha; fora do Linux não há esse arquivo e o
+// contador fica sempre em 0 (a tela reporta 0 bytes por quadro)
+static long long bytes_escritos_thread(void) {
+#ifdef __linux__
+    static int fd = -1;
+    static pthread_t dono;
+    char texto[256];
     
-    int linha = 0;
-    int cores_disponiveis = has_colors();
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        if (fd < 0 || !pthread_equal(dono, pthread_self())) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            fd = open("/proc/thread-self/io", O_RDONLY);
+            dono = pthread_self();
+            if (fd < 0) {
+                return -1;
+            }
+        }
+        ssize_t lidos = pread(fd, texto, sizeof(texto) - 1, 0);
+        if (lidos > 0) {
+            texto[lidos] = '\0';
+            const char *wchar = strstr(texto, "wchar:");
+            return wchar ? atoll(wchar + 6) : -1;
+        }
+        close(fd);
+        fd = -1;
+    }
+    return -1;
+#else
+    return 0;
+#endif
+}
+
+// Altura dos painéis de tedax e bancadas: título, linhas (algumas ocupam duas),
+// "... e mais" e a linha em branco que separa do painel seguinte
+static int altura_tedax(const RetratoTela *r) {
+    int altura = 2;
+    for (int i = 0; i < r->qtd_linhas_tedax; i++) {
+        const LinhaTedaxRetrato *t = &r->tedax[i];
+        altura++;
+        if (t->estado == TEDAX_OCUPADO && t->modulo_id >= 0 && t->fila_modulo_id >= 0) {
+            altura++; // "Fila: M<n>"
+        }
+    }
+    if (r->qtd_tedax > r->qtd_linhas_tedax) {
+        altura++;
+    }
+    return altura;
+}
+
+static int altura_bancadas(const RetratoTela *r) {
+    int altura = 2;
+    for (int i = 0; i < r->qtd_linhas_bancadas; i++) {
+        const LinhaBancadaRetrato *b = &r->bancadas[i];
+        altura++;
+        if (b->estado == BANCADA_OCUPADA && b->tedax_esperando >= 0) {
+            altura++; // "Esperando: Tedax <n>"
+        }
+    }
+    if (r->qtd_bancadas > r->qtd_linhas_bancadas) {
+        altura++;
+    }
+    return altura;
+}
+
+// Linhas da lista de módulos abaixo da janela do retrato
+static int modulos_abaixo(const RetratoTela *r, int visiveis) {
+    int abaixo = r->qtd_filtrados - r->primeira_linha - visiveis;
+    return abaixo > 0 ? abaixo : 0;
+}
+
+// Há filtro na lista de módulos?
+static int modulos_filtrados(const RetratoTela *r) {
+    return r->filtro_tipo >= 0 || r->filtro_estado >= 0;
+}
+
+// Dispõe os painéis para o retrato r: calcula posição e altura de cada um
+// Retorna 1 se a disposição mudou (painéis recriados), 0 se continua a mesma
+static int dispor_paineis(const RetratoTela *r) {
+    int y[QTD_PAINEIS], altura[QTD_PAINEIS];
+    y[PAINEL_CABECALHO] = 0;
+    altura[PAINEL_CABECALHO] = 4; // título, branco, dificuldade/tempo, branco
+    y[PAINEL_TEDAX] = 4;
+    altura[PAINEL_TEDAX] = altura_tedax(r);
+    y[PAINEL_BANCADAS] = y[PAINEL_TEDAX] + altura[PAINEL_TEDAX];
+    altura[PAINEL_BANCADAS] = altura_bancadas(r);
+    y[PAINEL_MODULOS] = y[PAINEL_BANCADAS] + altura[PAINEL_BANCADAS];
+    
+    // Módulos: a lista para 8 linhas antes do fim da tela (ao menos uma linha)
+    // O retrato traz só a janela da lista; o que passa dela vira "... (mais N)"
+    int capacidade = LINES - 9 - y[PAINEL_MODULOS];
+    if (capacidade < 1) capacidade = 1;
+    int visiveis = capacidade < r->qtd_linhas ? capacidade : r->qtd_linhas;
+    int vazia = r->qtd_filtrados == 0 && modulos_filtrados(r); // "(nenhum modulo...)"
+    altura[PAINEL_MODULOS] = 1 + visiveis + vazia + (modulos_abaixo(r, visiveis) > 0 ? 1 : 0) +
+                             (r->resolvidos_removidos > 0 ? 2 : 0) + 1;
+    y[PAINEL_ENTRADA] = y[PAINEL_MODULOS] + altura[PAINEL_MODULOS];
+    altura[PAINEL_ENTRADA] = 2; // "Comando: [...]" e branco
+    y[PAINEL_ERRO] = y[PAINEL_ENTRADA] + altura[PAINEL_ENTRADA];
+    altura[PAINEL_ERRO] = 1;
     
+    if (paineis.valido && paineis.linhas == LINES && paineis.colunas == COLS &&
+        paineis.modulos_visiveis == visiveis && paineis.modulos_capacidade == capacidade &&
+        memcmp(paineis.y, y, sizeof(y)) == 0 && memcmp(paineis.altura, altura, sizeof(altura)) == 0) {
+        return 0;
+    }
+    
+    for (int p = 0; p < QTD_PAINEIS; p++) {
+        if (paineis.janela[p]) {
+            delwin(paineis.janela[p]);
+            paineis.janela[p] = NULL;
+        }
+        int h = altura[p];
+        if (y[p] + h > LINES) {
+            h = LINES - y[p];
+        }
+        if (h > 0) {
+            paineis.janela[p] = newwin(h, COLS, y[p], 0);
+            if (paineis.janela[p]) {
+                leaveok(paineis.janela[p], TRUE); // cursor escondido: não movê-lo
+            }
+        }
+    }
+    memcpy(paineis.y, y, sizeof(y));
+    memcpy(paineis.altura, altura, sizeof(altura));
+    paineis.modulos_visiveis = visiveis;
+    paineis.modulos_capacidade = capacidade;
+    paineis.linhas = LINES;
+    paineis.colunas = COLS;
+    paineis.valido = 1;
+    
+    // Apagar o que sobrou da disposição anterior abaixo do último painel
+    werase(stdscr);
+    wnoutrefresh(stdscr);
+    return 1;
+}
+
+// Quais painéis mostram dados diferentes em a e b
+static int cabecalho_mudou(const RetratoTela *a, const RetratoTela *b) {
+    return a->dificuldade != b->dificuldade || a->tempo_restante != b->tempo_restante ||
+           a->resolvidos != b->resolvidos || a->modulos_necessarios != b->modulos_necessarios;
+}
+
+static int tedax_mudou(const RetratoTela *a, const RetratoTela *b) {
+    return a->qtd_tedax != b->qtd_tedax || a->qtd_linhas_tedax != b->qtd_linhas_tedax ||
+           memcmp(a->tedax, b->tedax, sizeof(LinhaTedaxRetrato) * a->qtd_linhas_tedax) != 0;
+}
+
+static int bancadas_mudou(const RetratoTela *a, const RetratoTela *b) {
+    return a->qtd_bancadas != b->qtd_bancadas || a->qtd_linhas_bancadas != b->qtd_linhas_bancadas ||
+           memcmp(a->bancadas, b->bancadas,
+                  sizeof(LinhaBancadaRetrato) * a->qtd_linhas_bancadas) != 0;
+}
+
+static int modulos_mudou(const RetratoTela *a, const RetratoTela *b, int visiveis) {
+    if (a->qtd_modulos != b->qtd_modulos || a->qtd_linhas != b->qtd_linhas ||
+        a->resolvidos_removidos != b->resolvidos_removidos ||
+        a->filtro_tipo != b->filtro_tipo || a->filtro_estado != b->filtro_estado ||
+        a->qtd_filtrados != b->qtd_filtrados || a->primeira_linha != b->primeira_linha) {
+        return 1;
+    }
+    for (int i = 0; i < visiveis; i++) {
+        const LinhaModuloRetrato *x = &a->linhas[i], *y = &b->linhas[i];
+        if (x->id != y->id || x->estado != y->estado || x->tempo_total != y->tempo_total ||
+            strcmp(x->info, y->info) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void desenhar_cabecalho(WINDOW *w, const RetratoTela *r, int cores_disponiveis) {
     // Título do jogo
-    attron(A_BOLD);
-    mvprintw(linha++, 0, "=== KEEP SOLVING AND NOBODY EXPLODES ===");
-    attroff(A_BOLD);
-    linha++;
+    wattron(w, A_BOLD);
+    mvwprintw(w, 0, 0, "=== KEEP SOLVING AND NOBODY EXPLODES ===");
+    wattroff(w, A_BOLD);
     
     // Tempo restante e dificuldade
     if (cores_disponiveis) {
-        attron(A_BOLD | COLOR_PAIR(1));
+        wattron(w, A_BOLD | COLOR_PAIR(1));
     } else {
-        attron(A_BOLD);
+        wattron(w, A_BOLD);
     }
-    mvprintw(linha++, 0, "Dificuldade: %s | Tempo Restante: %d segundos | Modulos: %d/%d resolvidos", 
-             nome_dificuldade(g->dificuldade), g->tempo_restante, 
-             contar_modulos_resolvidos(g), g->modulos_necessarios);
+    mvwprintw(w, 2, 0, "Dificuldade: %s | Tempo Restante: %d segundos | Modulos: %d/%d resolvidos", 
+              nome_dificuldade(r->dificuldade), r->tempo_restante, 
+              r->resolvidos, r->modulos_necessarios);
     if (cores_disponiveis) {
-        attroff(A_BOLD | COLOR_PAIR(1));
+        wattroff(w, A_BOLD | COLOR_PAIR(1));
     } else {
-        attroff(A_BOLD);
+        wattroff(w, A_BOLD);
     }
-    linha++;
-    
-    // Estado dos Tedax
-    mvprintw(linha++, 0, "--- TEDAX (%d total) ---", g->qtd_tedax);
-    for (int i = 0; i < g->qtd_tedax; i++) {
-        const Tedax *t = &g->tedax[i];
+}
+
+static void desenhar_tedax(WINDOW *w, const RetratoTela *r, int cores_disponiveis) {
+    int linha = 0;
+    mvwprintw(w, linha++, 0, "--- TEDAX (%d total) ---", r->qtd_tedax);
+    for (int i = 0; i < r->qtd_linhas_tedax; i++) {
+        const LinhaTedaxRetrato *t = &r->tedax[i];
         if (t->estado == TEDAX_LIVRE) {
             if (cores_disponiveis) {
-                attron(COLOR_PAIR(2)); // Verde
+                wattron(w, COLOR_PAIR(2)); // Verde
             }
-            mvprintw(linha++, 0, "  Tedax %d: LIVRE", t->id);
+            mvwprintw(w, linha++, 0, "  Tedax %d: LIVRE", t->id);
             if (cores_disponiveis) {
-                attroff(COLOR_PAIR(2));
+                wattroff(w, COLOR_PAIR(2));
             }
         } else if (t->estado == TEDAX_ESPERANDO) {
             if (cores_disponiveis) {
-                attron(COLOR_PAIR(3)); // Amarelo
+                wattron(w, COLOR_PAIR(3)); // Amarelo
             }
-            if (t->modulo_atual >= 0) {
-                const Modulo *mod = &g->modulos[t->modulo_atual];
-                mvprintw(linha++, 0, "  Tedax %d: ESPERANDO (Bancada %d) - Aguardando para M%d", 
-                         t->id, t->bancada_atual >= 0 ? g->bancadas[t->bancada_atual].id : 0,
-                         mod->id);
+            if (t->modulo_id >= 0) {
+                mvwprintw(w, linha++, 0, "  Tedax %d: ESPERANDO (Bancada %d) - Aguardando para M%d", 
+                          t->id, t->bancada_id, t->modulo_id);
             } else {
-                mvprintw(linha++, 0, "  Tedax %d: ESPERANDO (Bancada %d)", t->id, 
-                         t->bancada_atual >= 0 ? g->bancadas[t->bancada_atual].id : 0);
+                mvwprintw(w, linha++, 0, "  Tedax %d: ESPERANDO (Bancada %d)", t->id, t->bancada_id);
             }
             if (cores_disponiveis) {
-                attroff(COLOR_PAIR(3));
+                wattroff(w, COLOR_PAIR(3));
             }
         } else {
             if (cores_disponiveis) {
-                attron(COLOR_PAIR(3)); // Amarelo/Vermelho
+                wattron(w, COLOR_PAIR(3)); // Amarelo/Vermelho
             }
-            if (t->modulo_atual >= 0) {
-                const Modulo *mod = &g->modulos[t->modulo_atual];
+            if (t->modulo_id >= 0) {
                 char barra[32];
-                gerar_barra_progresso(barra, sizeof(barra), mod->tempo_total, mod->tempo_restante);
-                mvprintw(linha++, 0, "  Tedax %d: OCUPADO - Desarmando M%d - %s",
-                         t->id, mod->id, barra);
+                gerar_barra_progresso(barra, sizeof(barra), t->modulo_tempo_total, t->modulo_tempo_restante);
+                mvwprintw(w, linha++, 0, "  Tedax %d: OCUPADO - Desarmando M%d - %s",
+                          t->id, t->modulo_id, barra);
                 // Mostrar módulo em espera na linha de baixo
-                if (t->qtd_fila > 0 && t->fila_modulos[0] >= 0 && t->fila_modulos[0] < g->qtd_modulos) {
-                    const Modulo *mod_fila = &g->modulos[t->fila_modulos[0]];
-                    mvprintw(linha++, 0, "    Fila: M%d",
-                             mod_fila->id);
+                if (t->fila_modulo_id >= 0) {
+                    mvwprintw(w, linha++, 0, "    Fila: M%d",
+                              t->fila_modulo_id);
                 }
             } else {
-                mvprintw(linha++, 0, "  Tedax %d: OCUPADO", t->id);
+                mvwprintw(w, linha++, 0, "  Tedax %d: OCUPADO", t->id);
             }
             if (cores_disponiveis) {
-                attroff(COLOR_PAIR(3));
+                wattroff(w, COLOR_PAIR(3));
             }
         }
     }
-    linha++;
-    
-    // Estado das Bancadas
-    mvprintw(linha++, 0, "--- BANCADAS (%d total) ---", g->qtd_bancadas);
-    for (int i = 0; i < g->qtd_bancadas; i++) {
-        const Bancada *b = &g->bancadas[i];
+    if (r->qtd_tedax > r->qtd_linhas_tedax) {
+        mvwprintw(w, linha++, 0, "  ... e mais %d tedax", r->qtd_tedax - r->qtd_linhas_tedax);
+    }
+}
+
+static void desenhar_bancadas(WINDOW *w, const RetratoTela *r, int cores_disponiveis) {
+    int linha = 0;
+    mvwprintw(w, linha++, 0, "--- BANCADAS (%d total) ---", r->qtd_bancadas);
+    for (int i = 0; i < r->qtd_linhas_bancadas; i++) {
+        const LinhaBancadaRetrato *b = &r->bancadas[i];
         if (b->estado == BANCADA_LIVRE) {
             if (cores_disponiveis) {
-                attron(COLOR_PAIR(2));
+                wattron(w, COLOR_PAIR(2));
             }
-            mvprintw(linha++, 0, "  Bancada %d: LIVRE", b->id);
+            mvwprintw(w, linha++, 0, "  Bancada %d: LIVRE", b->id);
             if (cores_disponiveis) {
-                attroff(COLOR_PAIR(2));
+                wattroff(w, COLOR_PAIR(2));
             }
         } else {
             if (cores_disponiveis) {
-                attron(COLOR_PAIR(3));
+                wattron(w, COLOR_PAIR(3));
             }
-            mvprintw(linha++, 0, "  Bancada %d: OCUPADA (Tedax %d)", b->id, b->tedax_ocupando);
+            mvwprintw(w, linha++, 0, "  Bancada %d: OCUPADA (Tedax %d)", b->id, b->tedax_ocupando);
             if (b->tedax_esperando >= 0) {
-                mvprintw(linha++, 0, "    Esperando: Tedax %d", b->tedax_esperando);
+                mvwprintw(w, linha++, 0, "    Esperando: Tedax %d", b->tedax_esperando);
             }
             if (cores_disponiveis) {
-                attroff(COLOR_PAIR(3));
+                wattroff(w, COLOR_PAIR(3));
             }
         }
     }
+    if (r->qtd_bancadas > r->qtd_linhas_bancadas) {
+        mvwprintw(w, linha++, 0, "  ... e mais %d bancadas", r->qtd_bancadas - r->qtd_linhas_bancadas);
+    }
+}
+
+// Lista de módulos: a janela copiada no retrato (resolvidos antigos e filtros
+// já aplicados); o título mostra os filtros e, se a lista não cabe, o trecho
+// exibido; o que vem depois vira "... (mais N modulos)"
+static void desenhar_modulos(WINDOW *w, const RetratoTela *r, int visiveis) {
+    int linha = 0;
+    mvwprintw(w, linha, 0, "--- MODULOS (%d total) ---", r->qtd_modulos);
+    if (modulos_filtrados(r)) {
+        wprintw(w, " filtro: %s/%s",
+                r->filtro_estado >= 0 ? nome_estado_modulo((EstadoModulo)r->filtro_estado) : "todos",
+                r->filtro_tipo >= 0 ? nome_tipo_modulo((TipoModulo)r->filtro_tipo) : "todos");
+    }
+    if (r->primeira_linha > 0 || modulos_abaixo(r, visiveis) > 0) {
+        wprintw(w, " [%d-%d de %d]", r->primeira_linha + 1, r->primeira_linha + visiveis,
+                r->qtd_filtrados);
+    }
     linha++;
-    
-    // Lista de módulos
-    mvprintw(linha++, 0, "--- MODULOS (%d total) ---", g->qtd_modulos);
-    
-    // Primeiro, contar quantos módulos resolvidos estão dentro do tempo limite de 20s
-    int resolvidos_visiveis_20s = 0;
-    for (int i = 0; i < g->qtd_modulos; i++) {
-        const Modulo *mod = &g->modulos[i];
-        if (mod->estado == MOD_RESOLVIDO && mod->tempo_desde_resolvido >= 0 && mod->tempo_desde_resolvido < 20) {
-            resolvidos_visiveis_20s++;
-        }
+    if (r->qtd_filtrados == 0 && modulos_filtrados(r)) {
+        mvwprintw(w, linha++, 0, "  (nenhum modulo neste filtro; Tab/Shift+Tab trocam)");
     }
     
-    // Determinar tempo limite para remoção (10s se tiver 8-9 resolvidos, 20s caso contrário)
-    int tempo_limite_remocao = (resolvidos_visiveis_20s >= 8) ? 10 : 20;
-    
-    int pendentes = 0, em_execucao = 0, resolvidos = 0;
-    int modulos_exibidos = 0;
-    int modulos_nao_exibidos = 0;
-    
-    for (int i = 0; i < g->qtd_modulos; i++) {
-        const Modulo *mod = &g->modulos[i];
+    for (int i = 0; i < visiveis; i++) {
+        const LinhaModuloRetrato *mod = &r->linhas[i];
         
-        // Filtrar módulos resolvidos que já passaram do tempo limite
-        int deve_exibir = 1;
-        if (mod->estado == MOD_RESOLVIDO) {
-            if (mod->tempo_desde_resolvido < 0 || mod->tempo_desde_resolvido >= tempo_limite_remocao) {
-                deve_exibir = 0; // Não exibir módulos resolvidos antigos
-                modulos_nao_exibidos++;
-            }
-        }
-        
-        if (!deve_exibir) {
-            continue; // Pular módulos resolvidos antigos
-        }
-        
-        switch (mod->estado) {
-            case MOD_PENDENTE:
-                pendentes++;
-                break;
-            case MOD_EM_EXECUCAO:
-                em_execucao++;
-                break;
-            case MOD_RESOLVIDO:
-                resolvidos++;
-                break;
-        }
-        
-        // Mostrar detalhes do módulo usando função auxiliar
-        char info_modulo[128];
-        obter_info_exibicao_modulo(mod, info_modulo, sizeof(info_modulo));
-        
-        if (mod->estado == MOD_EM_EXECUCAO) {
-            mvprintw(linha, 0, "  M%d %s - %s", 
-                     mod->id, info_modulo, nome_estado_modulo(mod->estado));
-        } else if (mod->estado == MOD_RESOLVIDO) {
-            mvprintw(linha, 0, "  M%d %s - %s", 
-                     mod->id, info_modulo, nome_estado_modulo(mod->estado));
+        if (mod->estado == MOD_PENDENTE) {
+            mvwprintw(w, linha++, 0, "  M%d %s - %s - Execucao: %d sec", 
+                      mod->id, mod->info, nome_estado_modulo(mod->estado),
+                      mod->tempo_total);
         } else {
-            mvprintw(linha, 0, "  M%d %s - %s - Execucao: %d sec", 
-                     mod->id, info_modulo, nome_estado_modulo(mod->estado),
-                     mod->tempo_total);
-        }
-        
-        linha++;
-        modulos_exibidos++;
-        
-        // Limitar quantidade de módulos exibidos para não ultrapassar a tela
-        if (linha >= LINES - 8) {
-            // Contar quantos módulos ainda não foram processados
-            int restantes = 0;
-            for (int j = i + 1; j < g->qtd_modulos; j++) {
-                const Modulo *mod_rest = &g->modulos[j];
-                if (mod_rest->estado != MOD_RESOLVIDO || 
-                    (mod_rest->tempo_desde_resolvido >= 0 && mod_rest->tempo_desde_resolvido < tempo_limite_remocao)) {
-                    restantes++;
-                }
-            }
-            if (restantes > 0) {
-                mvprintw(linha++, 0, "  ... (mais %d modulos)", restantes);
-            }
-            break;
+            mvwprintw(w, linha++, 0, "  M%d %s - %s", 
+                      mod->id, mod->info, nome_estado_modulo(mod->estado));
         }
     }
+    if (modulos_abaixo(r, visiveis) > 0) {
+        mvwprintw(w, linha++, 0, "  ... (mais %d modulos)", modulos_abaixo(r, visiveis));
+    }
     
     // Se houver módulos não exibidos (resolvidos antigos), informar
-    if (modulos_nao_exibidos > 0) {
+    if (r->resolvidos_removidos > 0) {
         linha++;
-        mvprintw(linha++, 0, "  (%d resolvidos removidos)", modulos_nao_exibidos);
+        mvwprintw(w, linha++, 0, "  (%d resolvidos removidos)", r->resolvidos_removidos);
     }
-    
-    linha++;
-    
+}
 
+static void desenhar_erro(WINDOW *w, const RetratoTela *r, int cores_disponiveis) {
+    if (r->mensagem_erro[0] == '\0') {
+        return;
+    }
+    if (cores_disponiveis) {
+        wattron(w, A_BOLD | COLOR_PAIR(3)); // Bold e amarelo/vermelho
+    } else {
+        wattron(w, A_BOLD);
+    }
+    mvwprintw(w, 0, 0, "%s", r->mensagem_erro);
+    if (cores_disponiveis) {
+        wattroff(w, A_BOLD | COLOR_PAIR(3));
+    } else {
+        wattroff(w, A_BOLD);
+    }
+}
+
+// Desenha a interface do jogo: só os painéis que mudaram desde o último quadro
+long desenhar_tela(const RetratoTela *r) {
+    int tudo = dispor_paineis(r);
+    const RetratoTela *a = &paineis.anterior;
+    int cores_disponiveis = has_colors();
     
-    // Área de entrada
-    mvprintw(linha++, 0, "Comando: [%s]", buffer_instrucao);
-    linha++;
+    int mudou[QTD_PAINEIS];
+    mudou[PAINEL_CABECALHO] = tudo || cabecalho_mudou(r, a);
+    mudou[PAINEL_TEDAX] = tudo || tedax_mudou(r, a);
+    mudou[PAINEL_BANCADAS] = tudo || bancadas_mudou(r, a);
+    mudou[PAINEL_MODULOS] = tudo || modulos_mudou(r, a, paineis.modulos_visiveis);
+    mudou[PAINEL_ENTRADA] = tudo || strcmp(r->buffer_instrucao, a->buffer_instrucao) != 0;
+    mudou[PAINEL_ERRO] = tudo || strcmp(r->mensagem_erro, a->mensagem_erro) != 0;
     
-    // Mostrar mensagem de erro se houver
-    if (g->mensagem_erro[0] != '\0') {
-        if (cores_disponiveis) {
-            attron(A_BOLD | COLOR_PAIR(3)); // Bold e amarelo/vermelho
-        } else {
-            attron(A_BOLD);
+    for (int p = 0; p < QTD_PAINEIS; p++) {
+        WINDOW *w = paineis.janela[p];
+        if (!mudou[p] || !w) {
+            continue;
         }
-        mvprintw(linha++, 0, "%s", g->mensagem_erro);
-        if (cores_disponiveis) {
-            attroff(A_BOLD | COLOR_PAIR(3));
-        } else {
-            attroff(A_BOLD);
+        werase(w);
+        switch ((Painel)p) {
+            case PAINEL_CABECALHO:
+                desenhar_cabecalho(w, r, cores_disponiveis);
+                break;
+            case PAINEL_TEDAX:
+                desenhar_tedax(w, r, cores_disponiveis);
+                break;
+            case PAINEL_BANCADAS:
+                desenhar_bancadas(w, r, cores_disponiveis);
+                break;
+            case PAINEL_MODULOS:
+                desenhar_modulos(w, r, paineis.modulos_visiveis);
+                break;
+            case PAINEL_ENTRADA:
+                mvwprintw(w, 0, 0, "Comando: [%s]", r->buffer_instrucao);
+                break;
+            case PAINEL_ERRO:
+                desenhar_erro(w, r, cores_disponiveis);
+                break;
+            default:
+                break;
         }
-        linha++;
+        wnoutrefresh(w);
     }
+    paineis.anterior = *r;
     
-    refresh();
+    // Só o doupdate escreve no terminal
+    long long antes = bytes_escritos_thread();
+    doupdate();
+    long long depois = bytes_escritos_thread();
+    return antes >= 0 && depois >= antes ? (long)(depois - antes) : -1;
 }
 
 // Mostra menu pós-jogo (vitória ou derrota)
@@ -3,9 +3,24 @@
 
 #include "../game/game.h"
 
-// FUTURO: Esta função será uma thread (Exibição de Informações)
-// Desenha toda a interface do jogo na tela
-void desenhar_tela(const GameState *g, const char *buffer_instrucao);
+// Desenha a interface do jogo na tela a partir de um retrato publicado
+// A tela é dividida em painéis (janelas ncurses) e só os painéis cujos dados
+// mudaram desde o último quadro são redesenhados
+// Não lê o GameState: pode ser chamada sem nenhuma trava do jogo
+// Retorna quantos bytes o quadro mandou para o terminal, ou -1 se não há como
+// contar (lido de /proc/thread-self/io)
+// NOTA: Só uma thread (a que desenha) pode chamar esta função
+long desenhar_tela(const RetratoTela *r);
+
+// Faz o próximo desenhar_tela redesenhar todos os painéis (terminal
+// redimensionado ou tela apagada por quem não usa os painéis)
+void invalidar_tela(void);
+
+// Linhas de módulos que cabem no painel da lista, no último quadro (0 antes
+// do primeiro); quem desenha repassa para GameState.linhas_modulos_tela, e o
+// próximo retrato copia só essas linhas
+// NOTA: Só a thread que desenha pode chamar esta função
+int capacidade_lista_modulos(void);
 
 // Inicializa o ncurses
 void inicializar_ncurses(void);